@@ -0,0 +1,84 @@
+/*******************************************************************
+*   Analytics.cpp
+*   Boids
+*	agent
+*
+*	10/19/2026
+*******************************************************************/
+
+// This module contains per-frame flock analytics. See Analytics.h.
+
+#include <chrono>
+
+#include "Analytics.h"
+#include "Boids.h"
+
+void FlockAnalytics::reset(const int n) {
+	for (int i = 0; i < n; ++i) parent[i].store(i, std::memory_order_relaxed);
+}
+
+void FlockAnalytics::finalize(const Boid* const boids, const int n, FlockStats& stats) {
+	std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+	// component sizes, and polarization while we're passing through
+	component_size.assign(n, 0);
+	float sum_ux = 0.0f, sum_uy = 0.0f, mag;
+	for (int i = 0; i < n; ++i) {
+		++component_size[find(i)];
+
+		mag = sqrt(boids[i].vx * boids[i].vx + boids[i].vy * boids[i].vy);
+		if (mag > PREVENT_ZERO_RETURN) {
+			sum_ux += boids[i].vx / mag;
+			sum_uy += boids[i].vy / mag;
+		}
+	}
+	stats.polarization = n ? sqrt(sum_ux * sum_ux + sum_uy * sum_uy) / n : 0.0f;
+
+	stats.sizes.clear();
+	stats.stragglers = 0;
+	int largest_root = -1;
+	for (int r = 0; r < n; ++r) {
+		if (!component_size[r]) continue;
+
+		if (component_size[r] >= FLOCK_MIN_SIZE) {
+			stats.sizes.push_back(component_size[r]);
+			if (largest_root < 0 || component_size[r] > component_size[largest_root]) largest_root = r;
+		}
+		else {
+			stats.stragglers += component_size[r];
+		}
+	}
+	std::sort(stats.sizes.begin(), stats.sizes.end(), [](const int a, const int b) { return a > b; });
+	stats.flocks = static_cast<int>(stats.sizes.size());
+	stats.largest_size = stats.flocks ? stats.sizes[0] : 0;
+
+	// center of the largest flock
+	stats.largest_x = stats.largest_y = 0.0f;
+	if (largest_root >= 0) {
+#ifdef SCREEN_WRAP
+		// a flock can straddle the wrap, so average on the circle;
+		// a plain mean would put a flock split across the edge
+		// in the middle of the screen
+		float cx = 0.0f, sx = 0.0f, cy = 0.0f, sy = 0.0f;
+		for (int i = 0; i < n; ++i) {
+			if (find(i) != largest_root) continue;
+			cx += cos(boids[i].x * (2.0f * fPI / fP_MAX));
+			sx += sin(boids[i].x * (2.0f * fPI / fP_MAX));
+			cy += cos(boids[i].y * (2.0f * fPI / fP_MAX));
+			sy += sin(boids[i].y * (2.0f * fPI / fP_MAX));
+		}
+		stats.largest_x = (atan2f(-sx, -cx) + fPI) * (fP_MAX / (2.0f * fPI));
+		stats.largest_y = (atan2f(-sy, -cy) + fPI) * (fP_MAX / (2.0f * fPI));
+#else
+		for (int i = 0; i < n; ++i) {
+			if (find(i) != largest_root) continue;
+			stats.largest_x += boids[i].x;
+			stats.largest_y += boids[i].y;
+		}
+		stats.largest_x /= stats.largest_size;
+		stats.largest_y /= stats.largest_size;
+#endif
+	}
+
+	stats.finalize_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
@@ -0,0 +1,97 @@
+/*******************************************************************
+*   Analytics.h
+*   Boids
+*	agent
+*
+*	10/19/2026
+*******************************************************************/
+
+// This module contains per-frame flock analytics: number and sizes
+// of flocks, polarization (mean alignment) and the center of the
+// largest flock. Flocks are connected components of the neighbor
+// graph, which the physics kernel already walks, so rather than
+// repeat the neighbor search in a second pass the kernel feeds each
+// neighbor edge straight into a lock-free union-find as it goes.
+
+#ifndef ANALYTICS_H
+#define ANALYTICS_H
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "params.h"
+
+struct Boid;
+
+struct FlockStats {
+	// components with at least FLOCK_MIN_SIZE boids
+	int flocks;
+
+	// boids not in any such component
+	int stragglers;
+
+	int largest_size;
+	float largest_x, largest_y;
+
+	// |mean of unit velocities|, 0 (random) to 1 (all aligned)
+	float polarization;
+
+	// time spent in finalize, i.e. outside the kernel
+	float finalize_ms;
+
+	// sizes of all flocks, largest first
+	std::vector<int> sizes;
+};
+
+class FlockAnalytics {
+public:
+	FlockAnalytics() {}
+
+	// every boid its own component. Call before the step.
+	void reset(const int n);
+
+	// merge the components of a and b. Safe to call concurrently
+	// from any number of threads: roots are only ever linked by
+	// CAS, always from the larger index to the smaller, so no
+	// cycles can form and no lock is needed.
+	inline void unite(int a, int b) {
+		for (;;) {
+			a = find(a);
+			b = find(b);
+			if (a == b) return;
+			if (a < b) std::swap(a, b);
+
+			int expected = a;
+			if (parent[a].compare_exchange_weak(expected, b, std::memory_order_relaxed)) return;
+		}
+	}
+
+	// root of a's component, halving the path as we go
+	inline int find(int a) {
+		int p, gp;
+		for (;;) {
+			p = parent[a].load(std::memory_order_relaxed);
+			if (p == a) return a;
+			gp = parent[p].load(std::memory_order_relaxed);
+			if (p != gp) parent[a].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+			a = gp;
+		}
+	}
+
+	// gather stats once all edges are in. Call after the step,
+	// before the ping-pong swap, with the boids the graph was built on.
+	void finalize(const Boid* const boids, const int n, FlockStats& stats);
+
+private:
+	// NO copy construction or copy assignment.
+	FlockAnalytics(const FlockAnalytics&) = delete;
+	FlockAnalytics& operator=(const FlockAnalytics&) = delete;
+
+	std::atomic<int> parent[BOID_CAPACITY];
+
+	// scratch for finalize
+	std::vector<int> component_size;
+};
+
+#endif
@@ -0,0 +1,198 @@
+/*******************************************************************
+*   Autotune.cpp
+*   Boids
+*	agent
+*
+*	10/19/2026
+*******************************************************************/
+
+// This module contains the startup autotuner for thread count and
+// scheduling granularity. See Autotune.h.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "Autotune.h"
+
+#ifdef AUTOTUNE
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// chunking policies tried, as { first_chunk_divisor, guided_divisor }.
+// The first is the historical default.
+static const int CHUNK_POLICIES[][2] = { { 2, 2 }, { 1, 1 }, { 1, 2 }, { 1, 4 }, { 2, 4 }, { 4, 4 }, { 8, 8 } };
+
+static std::string hostName() {
+#ifdef _WIN32
+	const char* name = getenv("COMPUTERNAME");
+	return name ? name : "unknown";
+#else
+	char name[256];
+	if (gethostname(name, sizeof(name))) return "unknown";
+	name[sizeof(name) - 1] = '\0';
+	return name;
+#endif
+}
+
+static int hardwareThreads() {
+	return std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+}
+
+static void apply(Physics& physics, const Schedule& schedule) {
+	physics.initThreads(schedule.threads);
+	physics.first_chunk_divisor = schedule.first_chunk_divisor;
+	physics.guided_divisor = schedule.guided_divisor;
+}
+
+// median ms per step of schedule, always stepping from the same saved state
+static float timeSchedule(Physics& physics, const Schedule& schedule, const std::vector<Boid>& saved) {
+	apply(physics, schedule);
+
+	std::vector<float> times;
+	for (int i = 0; i < AUTOTUNE_WARMUP_STEPS + AUTOTUNE_STEPS; ++i) {
+		std::copy(saved.begin(), saved.end(), physics.in);
+
+		std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+		physics.processRules();
+		std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+		if (i >= AUTOTUNE_WARMUP_STEPS) times.push_back(std::chrono::duration<float, std::milli>(t1 - t0).count());
+	}
+
+	std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+	return times[times.size() / 2];
+}
+
+static Schedule calibrate(Physics& physics) {
+	// stash everything the trial steps disturb
+	const std::vector<Boid> saved(physics.in, physics.in + physics.num_boids);
+	const uint64_t step_count = physics.step_count;
+	const double sim_time = physics.sim_time;
+	const float time_since_last_frame = physics.time_since_last_frame;
+	physics.time_since_last_frame = AUTOTUNE_FRAME_MS;
+#ifdef FLOCK_ANALYTICS
+	const FlockStats flock_stats = physics.flock_stats;
+#endif
+
+	// thread counts: powers of 2, plus half the hardware threads
+	// (i.e. physical cores if SMT is on) and all of them
+	const int hw = hardwareThreads();
+	std::vector<int> thread_counts;
+	for (int t = 1; t < hw; t *= 2) thread_counts.push_back(t);
+	thread_counts.push_back(std::max(hw / 2, 1));
+	thread_counts.push_back(hw);
+	for (int& t : thread_counts) t = std::min(t, physics.num_boids);
+	std::sort(thread_counts.begin(), thread_counts.end());
+	thread_counts.erase(std::unique(thread_counts.begin(), thread_counts.end()), thread_counts.end());
+
+	// coordinate descent: best thread count with the default
+	// policy, then best policy at that thread count
+	Schedule best = { thread_counts.back(), CHUNK_POLICIES[0][0], CHUNK_POLICIES[0][1], 0.0f, false };
+	best.step_ms = timeSchedule(physics, best, saved);
+
+	Schedule trial = best;
+	for (int t : thread_counts) {
+		if (t == best.threads) continue;
+		trial.threads = t;
+		trial.step_ms = timeSchedule(physics, trial, saved);
+		if (trial.step_ms < best.step_ms) best = trial;
+	}
+
+	trial = best;
+	for (const int* policy : CHUNK_POLICIES) {
+		if (policy[0] == best.first_chunk_divisor && policy[1] == best.guided_divisor) continue;
+		trial.first_chunk_divisor = policy[0];
+		trial.guided_divisor = policy[1];
+		trial.step_ms = timeSchedule(physics, trial, saved);
+		if (trial.step_ms < best.step_ms) best = trial;
+	}
+
+	std::copy(saved.begin(), saved.end(), physics.in);
+	physics.step_count = step_count;
+	physics.sim_time = sim_time;
+	physics.time_since_last_frame = time_since_last_frame;
+
+	// trial steps flag despawns (prey eaten) and finalize analytics
+	// like any step; neither may outlive them
+	physics.discardPendingChanges();
+#ifdef FLOCK_ANALYTICS
+	physics.flock_stats = flock_stats;
+#endif
+
+	return best;
+}
+
+// cache lines are: host hardware_threads population threads first_chunk_divisor guided_divisor step_ms
+static bool loadCached(const std::string& host, const int hw, const int population, Schedule& schedule) {
+	std::ifstream f(AUTOTUNE_CACHE_FILE);
+	std::string line, h;
+	int w, n;
+	Schedule s;
+
+	while (std::getline(f, line)) {
+		std::istringstream ss(line);
+		if (!(ss >> h >> w >> n >> s.threads >> s.first_chunk_divisor >> s.guided_divisor >> s.step_ms)) continue;
+		if (h != host || w != hw || n != population) continue;
+		if (s.threads < 1 || s.first_chunk_divisor < 1 || s.guided_divisor < 1) continue;
+
+		s.from_cache = true;
+		schedule = s;
+		return true;
+	}
+
+	return false;
+}
+
+static void saveCached(const std::string& host, const int hw, const int population, const Schedule& schedule) {
+	// keep every other host/population entry
+	std::vector<std::string> kept;
+	{
+		std::ifstream f(AUTOTUNE_CACHE_FILE);
+		std::string line, h;
+		int w, n;
+		while (std::getline(f, line)) {
+			std::istringstream ss(line);
+			if ((ss >> h >> w >> n) && h == host && w == hw && n == population) continue;
+			if (!line.empty()) kept.push_back(line);
+		}
+	}
+
+	std::ofstream f(AUTOTUNE_CACHE_FILE);
+	if (!f) {
+		std::cout << "WARN: unable to write " << AUTOTUNE_CACHE_FILE << '.' << std::endl;
+		return;
+	}
+
+	for (const std::string& line : kept) f << line << '\n';
+	f << host << ' ' << hw << ' ' << population << ' ' << schedule.threads << ' ' << schedule.first_chunk_divisor << ' ' << schedule.guided_divisor << ' ' << schedule.step_ms << '\n';
+}
+
+Schedule autotune(Physics& physics, const bool force) {
+	const std::string host = hostName();
+	const int hw = hardwareThreads();
+	Schedule schedule;
+
+	if (force || !loadCached(host, hw, physics.num_boids, schedule)) {
+		schedule = calibrate(physics);
+		saveCached(host, hw, physics.num_boids, schedule);
+	}
+
+	apply(physics, schedule);
+	return schedule;
+}
+
+std::string describeSchedule(const Schedule& schedule) {
+	std::ostringstream out;
+	out << schedule.threads << " (" << (schedule.from_cache ? "cached" : "tuned") << ", chunks 1/" << schedule.first_chunk_divisor << " then 1/" << schedule.guided_divisor << ')';
+	return out.str();
+}
+
+#endif
@@ -0,0 +1,41 @@
+/*******************************************************************
+*   Autotune.h
+*   Boids
+*	agent
+*
+*	10/19/2026
+*******************************************************************/
+
+// This module contains the startup autotuner for thread count and
+// scheduling granularity. Neither hardware_concurrency() threads
+// (SMT siblings often hurt) nor one fixed chunking policy is best
+// across machines and populations, so this times a few short runs
+// of candidate schedules on the live state and keeps the fastest.
+// Results are cached per host and population in AUTOTUNE_CACHE_FILE.
+
+#ifndef AUTOTUNE_H
+#define AUTOTUNE_H
+
+#include <string>
+
+#include "Boids.h"
+
+struct Schedule {
+	int threads, first_chunk_divisor, guided_divisor;
+
+	// median step time when calibrated
+	float step_ms;
+
+	bool from_cache;
+};
+
+// use the cached schedule for this host and population if there is
+// one (and !force), otherwise calibrate and cache the result. Either
+// way the schedule is applied to physics, whose state is left as found,
+// except that queued spawns and despawns are dropped (as by a restore).
+Schedule autotune(Physics& physics, const bool force);
+
+// short description for the overlay, e.g. "4 (tuned, chunks 1/2 then 1/4)"
+std::string describeSchedule(const Schedule& schedule);
+
+#endif
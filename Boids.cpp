@@ -39,14 +39,23 @@
 //	R				-	randomize boid positions
 //	LCTRL			-	switch between mouse attraction and repulsion
 //	LSHIFT			-	toggle STRONG attraction/repulsion
+//	O				-	drop an obstacle at the mouse (FIELD_MODE)
+//	A				-	drop an attractor (repulsor if repelling) at the mouse (FIELD_MODE)
+//	C				-	clear all obstacles and attractors (FIELD_MODE)
+//	=				-	spawn a batch of boids at the mouse
+//	-				-	despawn a random batch of boids
+//	V				-	cycle present mode: immediate, vsync, capped to FRAME_CAP_FPS
+//	F5				-	save checkpoint to CHECKPOINT_FILE in the background
+//	F9				-	restore checkpoint from CHECKPOINT_FILE
+//	G				-	toggle flock analytics (FLOCK_ANALYTICS)
+//	T				-	re-run the thread/chunking autotuner (AUTOTUNE)
 //	ESC				-	quit
 //	Hold mouse btn	-	enable attraction/repulsion to mouse
 
 #include "Boids.h"
 
-// random number generator for boid initial positions
-std::random_device rd;
-std::mt19937 gen(rd());
+// distribution for boid initial positions
+// (the generator itself lives in Physics so it can be seeded)
 std::uniform_real_distribution<float> positionRandomDist(0.0, P_MAX);
 
 #ifdef DYNAMIC_COLOR_MODE
@@ -84,50 +93,86 @@ float fastdiffToDiff(const float fast_diff, const float c1, const float c2) {
 }
 #endif
 
-void Physics::launchThread(int start_idx, int end_idx) {
-	float diffx, diffy, x, y, Vx, Vy, modVx, modVy, modVmag, magVsquared, fMouseX, fMouseY;
-	float time_factor, factor, CMsumX, CMsumY, REPsumX, REPsumY, ALsumX, ALsumY;
-	int neighbors, boid, test_boid;
+void Physics::accumulateNeighbors(const int species, const float x, const float y, const float vx, const float vy, NeighborSums& sums, const int boid) {
+	float diffx, diffy, factor, CMsumX, CMsumY, REPsumX, REPsumY, ALsumX, ALsumY;
+	int test_boid, neighbors;
 
-	_MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+#ifndef FLOCK_ANALYTICS
+	// only flock analytics needs to know which boid this is
+	static_cast<void>(boid);
+#endif
+
+	sums.CMsumX = 0.0f; sums.CMsumY = 0.0f; sums.REPsumX = 0.0f; sums.REPsumY = 0.0f; sums.ALsumX = 0.0f; sums.ALsumY = 0.0f;
+	sums.neighbors = 0;
 
-	for (;;) {
-		for (boid = start_idx; boid <= end_idx; ++boid) {
+	// boids are sorted by species, so take one species' range at a
+	// time with everything about the pair hoisted out of the loop
+	for (int s = 0; s < species_table.num_species; ++s) {
+		const SpeciesPair& pair = species_table.pairs[species][s];
+		const float range = pair.range * NEIGHBOR_DISTANCE;
+		const float range_squared = range * range;
+		const int end = species_start[s + 1];
+
+#ifdef FLOCK_ANALYTICS
+		// flocks are single-species
+		const int flock_boid = (s == species) ? boid : -1;
+#endif
 
-			// bring boid's position and velocity local
-			x = in[boid].x;
-			y = in[boid].y;
-			Vx = in[boid].vx;
-			Vy = in[boid].vy;
+		CMsumX = 0.0f; CMsumY = 0.0f; REPsumX = 0.0f; REPsumY = 0.0f; ALsumX = 0.0f; ALsumY = 0.0f;
+		neighbors = 0;
 
-			time_factor = TICK_FACTOR * time_since_last_frame;
+		for (test_boid = species_start[s]; test_boid < end; ++test_boid) {
 
-			// apply mouse attraction/repulsion rules
-			if (mouse_buttons_down) {
-				fMouseX = static_cast<float>(mouse_x * P_MAX) / fWidth;
-				fMouseY = static_cast<float>(mouse_y * P_MAX) / fHeight;
 #ifdef SCREEN_WRAP
-				diffx = diff(x, fMouseX);
-				diffy = diff(y, fMouseY);
+			diffx = fastdiff(x, in[test_boid].x);
+			diffy = fastdiff(y, in[test_boid].y);
 #else
-				diffx = fMouseX - x;
-				diffy = fMouseY - y;
+			diffx = in[test_boid].x - x;
+			diffy = in[test_boid].y - y;
 #endif
+			// to optimize we don't branch on whether neighbor is self,
+			// which means we will always be counted as our own neighbor
+			// The only rule this affects is alignment (the others go to
+			// 0 due to distance being 0) and we deal with that later...
+			if (diffx * diffx + diffy * diffy < range_squared) {
 
-				// We update the velocity components by a factor proportional to time elapsed
-				// and ratio of component distance to the cursor to the total distance to the cursor
-				// for a natural-looking attraction model
-				factor = ((mouse_buttons_down) ? (repulsion_multiplier * ((repulsion_boost) ? STRONG_DOWN_STRENGTH_FACTOR : WEAK_MOUSE_DOWN_STRENGTH_FACTOR)) : 0.0f) / (sqrt(diffx * diffx + diffy * diffy) + PREVENT_ZERO_RETURN);
-				Vx += time_factor * diffx * factor;
-				Vy += time_factor * diffy * factor;
-			}
+#ifdef SCREEN_WRAP
+				diffx = fastdiffToDiff(diffx, x, in[test_boid].x);
+				diffy = fastdiffToDiff(diffy, y, in[test_boid].y);
+#endif
 
-			// apply neighbor-related rules for every other boid that's a neighbor
-			CMsumX = 0.0f; CMsumY = 0.0f; REPsumX = 0.0f; REPsumY = 0.0f; ALsumX = 0.0f; ALsumY = 0.0f;
+				// update center of mass rule by distance and direction to neigbor
+				CMsumX += diffx;
+				CMsumY += diffy;
+
+				factor = 1.0f / (diffx*diffx + diffy*diffy + PREVENT_ZERO_RETURN);
+				// update repulsion rule by ratio of component distance to square of total distance to neighbor
+				// for natural repulsion model
+				REPsumX -= diffx * factor;
+				REPsumY -= diffy * factor;
+
+				// update alignment rule by component velocity of neighbor
+				ALsumX += in[test_boid].vx;
+				ALsumY += in[test_boid].vy;
+
+				// keep track of total neighbor count for averaging these rule sums
+				++neighbors;
+
+#ifdef FLOCK_ANALYTICS
+				// every edge is seen from both ends, so only
+				// emit it from the end with the higher index
+				if (test_boid < flock_boid) flock.unite(boid, test_boid);
+#endif
+			}
+		}
 
-			neighbors = 0;
-			for (test_boid = 0; test_boid < NUMBER_OF_BOIDS; ++test_boid) {
+		// prey within reach is eaten. A pass of its own, only for
+		// pairs that eat, keeps the loop above free of it.
+		if (pair.eat_range > 0.0f) {
+			const float eat_range = pair.eat_range * NEIGHBOR_DISTANCE;
+			const float eat_range_squared = eat_range * eat_range;
 
+			for (test_boid = species_start[s]; test_boid < end; ++test_boid) {
 #ifdef SCREEN_WRAP
 				diffx = fastdiff(x, in[test_boid].x);
 				diffy = fastdiff(y, in[test_boid].y);
@@ -135,170 +180,421 @@ void Physics::launchThread(int start_idx, int end_idx) {
 				diffx = in[test_boid].x - x;
 				diffy = in[test_boid].y - y;
 #endif
-				// to optimize we don't branch on whether neighbor is self,
-				// which means we will always be counted as our own neighbor
-				// The only rule this affects is alignment (the others go to
-				// 0 due to distance being 0) and we deal with that later...
-				if (diffx * diffx + diffy * diffy < NEIGHBOR_DISTANCE_SQUARED) {
+				if (diffx * diffx + diffy * diffy < eat_range_squared) despawn(test_boid);
+			}
+		}
+
+		// ...namely here: we're in our own species' range, so take
+		// ourselves back out of the alignment sum
+		if (s == species) {
+			ALsumX -= vx;
+			ALsumY -= vy;
+		}
+
+		// weight this species' contribution by the pair's strengths
+		sums.CMsumX += params.center_of_mass * pair.cohesion * CMsumX;
+		sums.CMsumY += params.center_of_mass * pair.cohesion * CMsumY;
+		sums.REPsumX += params.repulsion * pair.repulsion * REPsumX;
+		sums.REPsumY += params.repulsion * pair.repulsion * REPsumY;
+		sums.ALsumX += params.alignment * pair.alignment * ALsumX;
+		sums.ALsumY += params.alignment * pair.alignment * ALsumY;
+		sums.neighbors += neighbors;
+	}
+}
 
+void Physics::mouseDelta(const float x, const float y, const float time_factor, float& dVx, float& dVy) const {
+	float diffx, diffy, factor;
+
+	const float fMouseX = static_cast<float>(mouse_x * P_MAX) / fWidth;
+	const float fMouseY = static_cast<float>(mouse_y * P_MAX) / fHeight;
 #ifdef SCREEN_WRAP
-					diffx = fastdiffToDiff(diffx, x, in[test_boid].x);
-					diffy = fastdiffToDiff(diffy, y, in[test_boid].y);
+	diffx = diff(x, fMouseX);
+	diffy = diff(y, fMouseY);
+#else
+	diffx = fMouseX - x;
+	diffy = fMouseY - y;
 #endif
 
-					// update center of mass rule by distance and direction to neigbor
-					CMsumX += diffx;
-					CMsumY += diffy;
+	// We update the velocity components by a factor proportional to time elapsed
+	// and ratio of component distance to the cursor to the total distance to the cursor
+	// for a natural-looking attraction model
+	factor = (repulsion_multiplier * ((repulsion_boost) ? params.strong_mouse : params.weak_mouse)) / (sqrt(diffx * diffx + diffy * diffy) + PREVENT_ZERO_RETURN);
+	dVx = time_factor * diffx * factor;
+	dVy = time_factor * diffy * factor;
+}
 
-					factor = 1.0f / (diffx*diffx + diffy*diffy + PREVENT_ZERO_RETURN);
-					// update repulsion rule by ratio of component distance to square of total distance to neighbor
-					// for natural repulsion model
-					REPsumX -= diffx * factor;
-					REPsumY -= diffy * factor;
+void Physics::storeBoid(Boid& b, const int species, float x, float y, float Vx, float Vy) const {
+	float modVx, modVy, modVmag;
 
-					// update alignment rule by component velocity of neighbor
-					ALsumX += in[test_boid].vx;
-					ALsumY += in[test_boid].vy;
+	b.species = static_cast<uint8_t>(species);
+	b.x = x;
+	b.y = y;
+
+	// store velocities back to global
+	b.vx = Vx;
+	b.vy = Vy;
+
+	// return to screen reference frame
+	x = fWidth * x / fP_MAX;
+	y = fHeight * y / fP_MAX;
+
+	// convert vel to screen frame, off by a constant fP_MAX
+	// (that's okay because we're about to normalize)
+	modVx = fWidth*Vx;
+	modVy = fHeight*Vy;
+	modVmag = 1.0f / sqrt(modVx*modVx + modVy*modVy + PREVENT_ZERO_RETURN);
+	Vx = modVx * modVmag;
+	Vy = modVy * modVmag;
+
+#ifdef DYNAMIC_COLOR_MODE
+	const Species& s = species_table.species[species];
+	b.color = s.fixed_color ? RGB(s.R, s.G, s.B) : angleToRGB(atan2f(Vx, Vy) + fPI);
+#endif
+
+	b.draw_x1 = static_cast<int>(x - LINE_LENGTH * Vx + 0.5f);
+	b.draw_y1 = static_cast<int>(y - LINE_LENGTH * Vy + 0.5f);
+	b.draw_x2 = static_cast<int>(x + LINE_LENGTH * Vx + 0.5f);
+	b.draw_y2 = static_cast<int>(y + LINE_LENGTH * Vy + 0.5f);
+}
+
+void Physics::processBoid(const int boid) {
+	float x, y, Vx, Vy, dVx, dVy, magVsquared;
+	float time_factor, factor;
+#ifdef FIELD_MODE
+	float fieldX, fieldY;
+#endif
+	NeighborSums sums;
+
+	const int species = in[boid].species;
+
+	// bring boid's position and velocity local
+	x = in[boid].x;
+	y = in[boid].y;
+	Vx = in[boid].vx;
+	Vy = in[boid].vy;
+
+	time_factor = params.tick_factor * time_since_last_frame;
+
+	// apply mouse attraction/repulsion rules, unless
+	// applyLateMouse will do it after the step
+	if (mouse_buttons_down && !late_mouse) {
+		mouseDelta(x, y, time_factor, dVx, dVy);
+		Vx += dVx;
+		Vy += dVy;
+	}
+
+#ifdef FIELD_MODE
+	// apply obstacle and attractor forces. They were baked into
+	// a grid ahead of time, so this is one bilinear sample
+	// no matter how many obstacles and attractors exist
+	if (field) {
+		field->sample(x, y, fieldX, fieldY);
+		Vx += time_factor * fieldX;
+		Vy += time_factor * fieldY;
+	}
+#endif
+
+	// apply neighbor-related rules for every other boid that's a neighbor
+#ifdef FLOCK_ANALYTICS
+	accumulateNeighbors(species, x, y, in[boid].vx, in[boid].vy, sums, analytics_enabled ? boid : -1);
+#else
+	accumulateNeighbors(species, x, y, in[boid].vx, in[boid].vy, sums);
+#endif
 
-					// keep track of total neighbor count for averaging these rule sums
-					++neighbors;
-				}
-			}
 #ifdef SCREEN_WRAP
-			// okay, this is a fun one. We update the velocity component by the time factor multiplied by the center of mass average, which is the center of mass sum computed
-			// in the loop above, divided by the number of neighbors.
-			// We do the same with repulsion and alignment (there we must subtract our own velocity as it's the only rule affected by the fact that we chose to not
-			// check whether the test boid is distinct (for speed), and thus count ourselves as a neighbor.
-			Vx += time_factor * (CMsumX * CENTER_OF_MASS_STRENGTH_FACTOR / neighbors + REPULSION_STRENGTH_FACTOR * REPsumX + (ALsumX - in[boid].vx) * ALIGNMENT_STRENGTH_FACTOR / neighbors);
-			Vy += time_factor * (CMsumY * CENTER_OF_MASS_STRENGTH_FACTOR / neighbors + REPULSION_STRENGTH_FACTOR * REPsumY + (ALsumY - in[boid].vx) * ALIGNMENT_STRENGTH_FACTOR / neighbors);
+	// okay, this is a fun one. We update the velocity component by the time factor multiplied by the center of mass average, which is the center of mass sum computed
+	// in the loop above, divided by the number of neighbors.
+	// We do the same with repulsion and alignment. The sums come back already weighted by each species pair's strengths.
+	Vx += time_factor * (sums.CMsumX / sums.neighbors + sums.REPsumX + sums.ALsumX / sums.neighbors);
+	Vy += time_factor * (sums.CMsumY / sums.neighbors + sums.REPsumY + sums.ALsumY / sums.neighbors);
 #else
-			// the same occurs with screenwrap off as the above description, with one change: now repulsion also includes
-			// a term for repelling off the edges of the screen, if within range, inversely proportional to distance from edge
-			Vx += time_factor * (CMsumX * CENTER_OF_MASS_STRENGTH_FACTOR / neighbors + REPULSION_STRENGTH_FACTOR * (REPsumX + EDGE_REPULSION_STRENGTH_FACTOR*(x < NEIGHBOR_DISTANCE)*(NEIGHBOR_DISTANCE - x) - EDGE_REPULSION_STRENGTH_FACTOR*(x > fP_MAX - NEIGHBOR_DISTANCE)*(x - (fP_MAX - NEIGHBOR_DISTANCE))) + (ALsumX - in[boid].vx) * ALIGNMENT_STRENGTH_FACTOR / neighbors);
-			Vy += time_factor * (CMsumY * CENTER_OF_MASS_STRENGTH_FACTOR / neighbors + REPULSION_STRENGTH_FACTOR * (REPsumY + EDGE_REPULSION_STRENGTH_FACTOR*(y < NEIGHBOR_DISTANCE)*(NEIGHBOR_DISTANCE - y) - EDGE_REPULSION_STRENGTH_FACTOR*(y > fP_MAX - NEIGHBOR_DISTANCE)*(y - (fP_MAX - NEIGHBOR_DISTANCE))) + (ALsumY - in[boid].vx) * ALIGNMENT_STRENGTH_FACTOR / neighbors);
+	// the same occurs with screenwrap off as the above description, with one change: now repulsion also includes
+	// a term for repelling off the edges of the screen, if within range, inversely proportional to distance from edge
+	Vx += time_factor * (sums.CMsumX / sums.neighbors + sums.REPsumX + params.repulsion * (params.edge_repulsion*(x < NEIGHBOR_DISTANCE)*(NEIGHBOR_DISTANCE - x) - params.edge_repulsion*(x > fP_MAX - NEIGHBOR_DISTANCE)*(x - (fP_MAX - NEIGHBOR_DISTANCE))) + sums.ALsumX / sums.neighbors);
+	Vy += time_factor * (sums.CMsumY / sums.neighbors + sums.REPsumY + params.repulsion * (params.edge_repulsion*(y < NEIGHBOR_DISTANCE)*(NEIGHBOR_DISTANCE - y) - params.edge_repulsion*(y > fP_MAX - NEIGHBOR_DISTANCE)*(y - (fP_MAX - NEIGHBOR_DISTANCE))) + sums.ALsumY / sums.neighbors);
 #endif
 
-			// limit velocity if over V_LIM
-			magVsquared = Vx*Vx + Vy*Vy;
-			factor = (magVsquared > V_LIM_2) ? V_LIM / sqrt(magVsquared) : 1.0f;
-			Vx *= factor;
-			Vy *= factor;
+	// limit velocity if over this species' v_lim
+	const float v_lim = params.v_lim * species_table.species[species].speed;
+	magVsquared = Vx*Vx + Vy*Vy;
+	factor = (magVsquared > v_lim * v_lim) ? v_lim / sqrt(magVsquared) : 1.0f;
+	Vx *= factor;
+	Vy *= factor;
 
 #ifdef SCREEN_WRAP
-			// update position...
-			x += Vx * time_factor;
-			y += Vy * time_factor;
-			// ...then screenwrap it and store the result both to
-			// the local component and to the global out array
-			out[boid].x = (x += fP_MAX*((x < 0.0f) - (x >= fP_MAX)));
-			out[boid].y = (y += fP_MAX*((y < 0.0f) - (y >= fP_MAX)));
+	// update position...
+	x += Vx * time_factor;
+	y += Vy * time_factor;
+	// ...then screenwrap it
+	x += fP_MAX*((x < 0.0f) - (x >= fP_MAX));
+	y += fP_MAX*((y < 0.0f) - (y >= fP_MAX));
 #else
-			// if not screenwrapping,
-			// adjust the sign of the velocity of any boid outside the box
-			// so it's heading inside again in case that wasn't handled
-			// by the repulsion force.
-			//
-			// do NOT just bring its position to some value like 0.0f
-			// because then multiple boids would collide (share the exact
-			// same position) and thus might move together in future
-			// if their velocities also match (as they might well - reduced
-			// to a zero or V_LIM equilibrium in a corner, say)...
-			if (x < 0.0f) Vx = fabs(Vx);
-			if (x >= fP_MAX) Vx = -fabs(Vx);
-			if (y < 0.0f) Vy = fabs(Vy);
-			if (y >= fP_MAX) Vy = -fabs(Vy);
-
-			// ...and THEN update position so we move back inside
-			// without looking too unnaturally bounded
-			x += Vx * time_factor;
-			y += Vy * time_factor;
-
-			out[boid].x = x;
-			out[boid].y = y;
+	// if not screenwrapping,
+	// adjust the sign of the velocity of any boid outside the box
+	// so it's heading inside again in case that wasn't handled
+	// by the repulsion force.
+	//
+	// do NOT just bring its position to some value like 0.0f
+	// because then multiple boids would collide (share the exact
+	// same position) and thus might move together in future
+	// if their velocities also match (as they might well - reduced
+	// to a zero or V_LIM equilibrium in a corner, say)...
+	if (x < 0.0f) Vx = fabs(Vx);
+	if (x >= fP_MAX) Vx = -fabs(Vx);
+	if (y < 0.0f) Vy = fabs(Vy);
+	if (y >= fP_MAX) Vy = -fabs(Vy);
+
+	// ...and THEN update position so we move back inside
+	// without looking too unnaturally bounded
+	x += Vx * time_factor;
+	y += Vy * time_factor;
 #endif
 
-			// store velocities back to global
-			out[boid].vx = Vx;
-			out[boid].vy = Vy;
+	storeBoid(out[boid], species, x, y, Vx, Vy);
+}
 
-			// return to screen reference frame
-			x = fWidth * x / fP_MAX;
-			y = fHeight * y / fP_MAX;
+void Physics::refreshDrawData() {
+	for (int boid = 0; boid < num_boids; ++boid) storeBoid(in[boid], in[boid].species, in[boid].x, in[boid].y, in[boid].vx, in[boid].vy);
+}
 
-			// convert vel to screen frame, off by a constant fP_MAX
-			// (that's okay because we're about to normalize)
-			modVx = fWidth*Vx;
-			modVy = fHeight*Vy;
-			modVmag = 1.0f / sqrt(modVx*modVx + modVy*modVy + PREVENT_ZERO_RETURN);
-			Vx = modVx * modVmag;
-			Vy = modVy * modVmag;
+void Physics::applyLateMouse() {
+	float x, y, Vx, Vy, dVx, dVy, magVsquared, factor;
 
-#ifdef DYNAMIC_COLOR_MODE
-			out[boid].color = angleToRGB(atan2f(Vx, Vy) + fPI);
-#endif
+	if (!mouse_buttons_down) return;
 
-			out[boid].draw_x1 = static_cast<int>(x - LINE_LENGTH * Vx + 0.5f);
-			out[boid].draw_y1 = static_cast<int>(y - LINE_LENGTH * Vy + 0.5f);
-			out[boid].draw_x2 = static_cast<int>(x + LINE_LENGTH * Vx + 0.5f);
-			out[boid].draw_y2 = static_cast<int>(y + LINE_LENGTH * Vy + 0.5f);
+	const float time_factor = params.tick_factor * time_since_last_frame;
 
-		} // dynamic thread reassign
-		mtx.lock();
-		if (cur_idx >= NUMBER_OF_BOIDS) {
-			mtx.unlock();
-			return;
-		}
-		start_idx = cur_idx;
-		cur_idx += (NUMBER_OF_BOIDS - cur_idx) / num_CPU / 2 + 1;
-		end_idx = cur_idx - 1;
-		mtx.unlock();
-	}
-}
+	// linear and cheap next to the step, so serial
+	for (int boid = 0; boid < num_boids; ++boid) {
+		x = out[boid].x;
+		y = out[boid].y;
 
-void Physics::initThreads() {
-#ifdef OVERRIDE_CPU_COUNT_AUTODETECT
-	num_CPU = OVERRIDE_CPU_COUNT_AUTODETECT;
-#else
-	num_CPU = std::min(static_cast<unsigned int>(NUMBER_OF_BOIDS), std::thread::hardware_concurrency());
+		mouseDelta(x, y, time_factor, dVx, dVy);
+		Vx = out[boid].vx + dVx;
+		Vy = out[boid].vy + dVy;
+
+		const float v_lim = params.v_lim * species_table.species[out[boid].species].speed;
+		magVsquared = Vx*Vx + Vy*Vy;
+		factor = (magVsquared > v_lim * v_lim) ? v_lim / sqrt(magVsquared) : 1.0f;
+		Vx *= factor;
+		Vy *= factor;
+
+		// the step already moved the boid by its old
+		// velocity, so just make up the difference
+		x += (Vx - out[boid].vx) * time_factor;
+		y += (Vy - out[boid].vy) * time_factor;
+#ifdef SCREEN_WRAP
+		x += fP_MAX*((x < 0.0f) - (x >= fP_MAX));
+		y += fP_MAX*((y < 0.0f) - (y >= fP_MAX));
 #endif
 
-	threads = new std::thread[num_CPU];
+		storeBoid(out[boid], out[boid].species, x, y, Vx, Vy);
+	}
+}
+
+void Physics::seedRNG(const unsigned int seed) {
+	gen.seed(seed);
 }
 
 void Physics::spawnBoids() {
+	// split the population between species by their counts,
+	// in species order, so in starts out sorted
+	const int64_t total_count = std::max(species_table.totalCount(), 1);
+	int64_t running_count = 0;
+	int species = 0;
+
 	// generate host-side random initial positions
-	for (int i = 0; i < NUMBER_OF_BOIDS; ++i) {
+	for (int i = 0; i < num_boids; ++i) {
+		while (species < species_table.num_species - 1 && i >= (running_count + species_table.species[species].count) * num_boids / total_count) running_count += species_table.species[species++].count;
+		in[i].species = static_cast<uint8_t>(species);
+
 		in[i].vx = in[i].vy = 0.0f;
 
 		in[i].x = positionRandomDist(gen);
 		in[i].y = positionRandomDist(gen);
 	}
+
+	updateSpeciesRanges();
+	discardPendingChanges();
+
+	step_count = 0;
+	sim_time = 0.0;
 }
 
-void Physics::processRules() {
-	int start_idx;
-
-	// send out threads, each with half the naive workload,
-	// i.e. for 8 cores, give each 1/16 of the work to start
-	// with. This way, when some return before others, they
-	// can be dynamically assigned more work (occurs in the
-	// 'launchThread' method, mutexed by mtx) in smaller and
-	// smaller increments such that at the end, all threads
-	// finish up the last few boids at the same time
-	mtx.lock();
-	for (int i = 0; i < num_CPU; ++i) {
-		start_idx = cur_idx;
-		cur_idx += NUMBER_OF_BOIDS / num_CPU / 2 + 1;
-		threads[i] = std::thread(&Physics::launchThread, this, start_idx, cur_idx - 1);
+Physics::Physics(const int pool_capacity, const bool with_field) : mouse_buttons_down(0), repulsion_boost(false), repulsion_multiplier(1.0f), capacity(pool_capacity), in_arr(pool_capacity), out_arr(pool_capacity), mouse_x(0.0f), mouse_y(0.0f), gen(std::random_device()()), despawned(pool_capacity), spawn_queue(pool_capacity) {
+	in = in_arr.data();
+	out = out_arr.data();
+
+#ifdef FIELD_MODE
+	if (with_field) field.reset(new Field());
+#else
+	static_cast<void>(with_field);
+#endif
+
+	discardPendingChanges();
+}
+
+bool Physics::spawn(const float x, const float y, const float vx, const float vy, const int species) {
+	const int slot = num_spawned.fetch_add(1, std::memory_order_relaxed);
+	if (slot >= capacity) return false;
+
+	spawn_queue[slot].species = static_cast<uint8_t>(species);
+	spawn_queue[slot].x = x;
+	spawn_queue[slot].y = y;
+	spawn_queue[slot].vx = vx;
+	spawn_queue[slot].vy = vy;
+	return true;
+}
+
+void Physics::despawn(const int boid) {
+	// count each boid once no matter how many times it's flagged
+	if (!despawned[boid].exchange(true, std::memory_order_relaxed)) num_despawned.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Physics::despawnRandom(const int count) {
+	const int n = std::min(count, num_boids - 1);
+	if (n <= 0) return;
+
+	// partial shuffle: the first n indices are a distinct random pick
+	std::vector<int> picks(num_boids);
+	for (int i = 0; i < num_boids; ++i) picks[i] = i;
+	for (int i = 0; i < n; ++i) {
+		std::swap(picks[i], picks[std::uniform_int_distribution<int>(i, num_boids - 1)(gen)]);
+		despawn(picks[i]);
+	}
+}
+
+void Physics::discardPendingChanges() {
+	for (int i = 0; i < capacity; ++i) despawned[i].store(false, std::memory_order_relaxed);
+	num_despawned.store(0, std::memory_order_relaxed);
+	num_spawned.store(0, std::memory_order_relaxed);
+}
+
+void Physics::countSurvivors(const int chunk, const int chunks) {
+	const int end = static_cast<int>(static_cast<int64_t>(num_boids) * (chunk + 1) / chunks);
+	int survivors = 0;
+	for (int i = static_cast<int>(static_cast<int64_t>(num_boids) * chunk / chunks); i < end; ++i) survivors += !despawned[i].load(std::memory_order_relaxed);
+	compact_offsets[chunk] = survivors;
+}
+
+void Physics::moveSurvivors(const int chunk, const int chunks) {
+	const int end = static_cast<int>(static_cast<int64_t>(num_boids) * (chunk + 1) / chunks);
+	int dst = compact_offsets[chunk];
+	for (int i = static_cast<int>(static_cast<int64_t>(num_boids) * chunk / chunks); i < end; ++i) {
+		if (despawned[i].load(std::memory_order_relaxed)) despawned[i].store(false, std::memory_order_relaxed);
+		else in[dst++] = out[i];
 	}
-	mtx.unlock();
+}
+
+void Physics::swapBuffers() {
+	const int despawns = num_despawned.exchange(0, std::memory_order_relaxed);
+	const int spawns = std::min(num_spawned.exchange(0, std::memory_order_relaxed), capacity);
+
+	if (!despawns) {
+		// the common case: plain ping-pong
+		Boid* temp = in;
+		in = out;
+		out = temp;
+	}
+	else {
+		// stable compaction of the survivors out of out and
+		// into in, which is stale now and so is free to use.
+		// Worth threads only for large populations.
+		const int chunks = (threads && num_boids >= COMPACTION_PARALLEL_MIN) ? num_CPU : 1;
+		compact_offsets.resize(chunks);
+
+		if (chunks == 1) {
+			compact_offsets[0] = 0;
+			moveSurvivors(0, 1);
+		}
+		else {
+			for (int i = 0; i < chunks; ++i) threads[i] = std::thread(&Physics::countSurvivors, this, i, chunks);
+			for (int i = 0; i < chunks; ++i) threads[i].join();
+
+			// exclusive prefix sum: where each chunk's survivors go
+			int offset = 0;
+			for (int i = 0; i < chunks; ++i) {
+				const int survivors = compact_offsets[i];
+				compact_offsets[i] = offset;
+				offset += survivors;
+			}
+
+			for (int i = 0; i < chunks; ++i) threads[i] = std::thread(&Physics::moveSurvivors, this, i, chunks);
+			for (int i = 0; i < chunks; ++i) threads[i].join();
+		}
+
+		num_boids -= despawns;
+	}
+
+	// spawns fill the free tail of the pool...
+	const int added = std::min(spawns, capacity - num_boids);
+	for (int i = 0; i < added; ++i) in[num_boids + i] = spawn_queue[i];
+	num_boids += added;
+
+	// ...then move to their species' range. Compaction is
+	// stable, so despawns alone leave in sorted.
+	if (added && species_table.num_species > 1) sortBySpecies();
+	else if (added || despawns) updateSpeciesRanges();
+}
+
+void Physics::sortBySpecies() {
+	int count[MAX_SPECIES + 1] = {};
+	int i;
 
-	// wait for all threads to return
-	for (int i = 0; i < num_CPU; ++i) {
-		threads[i].join();
+	// stable counting sort from in into out
+	for (i = 0; i < num_boids; ++i) ++count[in[i].species + 1];
+	for (i = 1; i <= MAX_SPECIES; ++i) count[i] += count[i - 1];
+	for (i = 0; i < num_boids; ++i) out[count[in[i].species]++] = in[i];
+
+	Boid* temp = in;
+	in = out;
+	out = temp;
+
+	updateSpeciesRanges();
+}
+
+void Physics::updateSpeciesRanges() {
+	int s = 0;
+	species_start[0] = 0;
+	for (int i = 0; i < num_boids; ++i) {
+		while (s < in[i].species) species_start[++s] = i;
 	}
+	while (s < MAX_SPECIES) species_start[++s] = num_boids;
+}
+
+void Physics::beginStep() {
+#ifdef FIELD_MODE
+	// rebake the field if obstacles or attractors
+	// changed since last frame
+	if (field) field->update();
+#endif
 
-	// reset for next frame
-	cur_idx = 0;
+#ifdef FLOCK_ANALYTICS
+	if (analytics_enabled) flock.reset(num_boids);
+#endif
+}
+
+void Physics::endStep() {
+#ifdef FLOCK_ANALYTICS
+	if (analytics_enabled) flock.finalize(in, num_boids, flock_stats);
+#endif
 
+	++step_count;
+	sim_time += time_since_last_frame;
+}
+
+void Physics::processRules() {
+	beginStep();
+
+	// send out threads, each with a fraction (by default half)
+	// of the naive workload, i.e. for 8 cores, give each 1/16 of
+	// the work to start with. This way, when some return before
+	// others, they can be dynamically assigned more work in
+	// smaller and smaller increments such that at the end, all
+	// threads finish up the last few boids at the same time
+	schedule(num_boids, [this](const int start_idx, const int end_idx) {
+		for (int boid = start_idx; boid <= end_idx; ++boid) processBoid(boid);
+	});
+
+	endStep();
 }
\ No newline at end of file
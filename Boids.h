@@ -40,6 +40,16 @@
 	//PRINT_SCREEN	-	save screenshot to <current time>.bmp so you don't have to quit or ALT-TAB to do so
 	//LCTRL			-	switch between mouse attraction and repulsion
 	//LSHIFT			-	toggle STRONG attraction/repulsion
+	//O				-	drop an obstacle at the mouse (FIELD_MODE)
+	//A				-	drop an attractor (repulsor if repelling) at the mouse (FIELD_MODE)
+	//C				-	clear all obstacles and attractors (FIELD_MODE)
+	//=				-	spawn a batch of boids at the mouse
+	//-				-	despawn a random batch of boids
+	//V				-	cycle present mode: immediate, vsync, capped to FRAME_CAP_FPS
+	//F5				-	save checkpoint to CHECKPOINT_FILE in the background
+	//F9				-	restore checkpoint from CHECKPOINT_FILE
+	//G				-	toggle flock analytics (FLOCK_ANALYTICS)
+	//T				-	re-run the thread/chunking autotuner (AUTOTUNE)
 	//ESC				-	quit
 	//Hold mouse btn	-	enable attraction/repulsion to mouse
 
@@ -64,11 +74,27 @@
 #endif // _DEBUG
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
 #include <mutex>
 #include <random>
 #include <thread>
+#include <vector>
+#include <xmmintrin.h>
 
 #include "params.h"
+#include "Scheduler.h"
+#include "Species.h"
+
+#ifdef FIELD_MODE
+#include "Field.h"
+#endif
+
+#ifdef FLOCK_ANALYTICS
+#include "Analytics.h"
+#endif
 
 #ifdef DYNAMIC_COLOR_MODE
 struct RGB {
@@ -86,10 +112,33 @@ struct Boid {
 	RGB color;
 #endif
 
+	// index into the species table
+	uint8_t species;
+
 	int draw_x1, draw_y1, draw_x2, draw_y2;
 };
 
-class Physics {
+// rule strengths, runtime so one process can run
+// worlds with different settings (see Ensemble.h).
+// Defaults are the params.h values.
+struct SimParams {
+	float v_lim = V_LIM;
+	float tick_factor = TICK_FACTOR;
+	float alignment = ALIGNMENT_STRENGTH_FACTOR;
+	float repulsion = REPULSION_STRENGTH_FACTOR;
+	float edge_repulsion = EDGE_REPULSION_STRENGTH_FACTOR;
+	float center_of_mass = CENTER_OF_MASS_STRENGTH_FACTOR;
+	float weak_mouse = WEAK_MOUSE_DOWN_STRENGTH_FACTOR;
+	float strong_mouse = STRONG_DOWN_STRENGTH_FACTOR;
+};
+
+// running sums of the neighbor rules for a single boid
+struct NeighborSums {
+	float CMsumX, CMsumY, REPsumX, REPsumY, ALsumX, ALsumY;
+	int neighbors;
+};
+
+class Physics : public Scheduler {
 public:
 	int last_total_time;
 
@@ -100,28 +149,70 @@ public:
 	float repulsion_multiplier;
 	bool repulsion_boost;
 
-	int num_CPU;
+	// apply the mouse in applyLateMouse, after the step,
+	// rather than in the kernel
+	bool late_mouse = false;
 
-	bool not_paused = true;
+	SimParams params;
 
-	float fWidth, fHeight;
+	// per-species and per-pair multipliers on params (see Species.h)
+	SpeciesTable species_table;
+
+	// in[species_start[s], species_start[s + 1]) are species s.
+	// Kept up to date by spawnBoids, swapBuffers and sortBySpecies.
+	int species_start[MAX_SPECIES + 1];
+
+	// size of the boid pool: BOID_CAPACITY, or less
+	// for worlds that never grow (ensemble worlds)
+	const int capacity;
+
+	// live population, at most capacity. Live boids are
+	// always in[0, num_boids); the rest of the pool is free.
+	int num_boids = NUMBER_OF_BOIDS;
+
+	bool not_paused = true;
 
-	// current boid to process, for threading
-	int cur_idx = 0;
+	// completed steps and simulated milliseconds since spawn
+	uint64_t step_count = 0;
+	double sim_time = 0.0;
 
-	// for blocking cur_idx
-	std::mutex mtx;
+	float fWidth, fHeight;
 
-	Boid in_arr[NUMBER_OF_BOIDS];
-	Boid out_arr[NUMBER_OF_BOIDS];
+	std::vector<Boid> in_arr;
+	std::vector<Boid> out_arr;
 
 	Boid* in;
 	Boid* out;
 
-	std::thread* threads;
+	// random number generator for boid initial positions
+	std::mt19937 gen;
+
+#ifdef FIELD_MODE
+	// static obstacles and attractors, baked into a grid.
+	// Null in worlds made without one (ensemble worlds).
+	std::unique_ptr<Field> field;
+#endif
+
+#ifdef FLOCK_ANALYTICS
+	// neighbor-graph union-find, fed by the kernel
+	FlockAnalytics flock;
+
+	// results for the last step, if analytics_enabled
+	FlockStats flock_stats;
+
+	bool analytics_enabled = true;
+#endif
 
 private:
+	// population changes requested during a step,
+	// applied together by swapBuffers
+	std::vector<std::atomic<bool>> despawned;
+	std::atomic<int> num_despawned;
+	std::vector<Boid> spawn_queue;
+	std::atomic<int> num_spawned;
 
+	// per-thread survivor counts, then output offsets, for compaction
+	std::vector<int> compact_offsets;
 
 public:
 	// Singleton idiom - only one
@@ -133,22 +224,89 @@ public:
 		return instance;
 	};
 
-	~Physics() { delete[] threads; }
-
-	void initThreads();
+	// reseed the generator, for reproducible spawns
+	void seedRNG(const unsigned int seed);
 
 	void spawnBoids();
 
 	void processRules();
 
+	// mouse attraction/repulsion as a cheap pass over out, for
+	// when late_mouse is set. Call after processRules with the
+	// freshest mouse state available, just before drawing.
+	void applyLateMouse();
+
+	// recompute in's draw data from its positions and velocities,
+	// to show state that didn't come out of a step (e.g. a respawn
+	// or checkpoint restore while paused)
+	void refreshDrawData();
+
+	// queue a boid (in simulation coordinates) to join at the next
+	// swapBuffers. Safe to call from the kernel threads. Returns
+	// false if the queue is full.
+	bool spawn(const float x, const float y, const float vx, const float vy, const int species = 0);
+
+	// flag a live boid for removal at the next swapBuffers.
+	// Safe to call from the kernel threads, any number of times.
+	void despawn(const int boid);
+
+	// flag count distinct random live boids, but never the last one
+	void despawnRandom(const int count);
+
+	// restore the species ordering of in, e.g. after loading
+	// boids from elsewhere. Uses out as scratch.
+	void sortBySpecies();
+
+	// drop any queued spawns and despawns
+	void discardPendingChanges();
+
+	// ping-pong in and out after a step, then apply queued
+	// despawns and spawns so in is dense again
+	void swapBuffers();
+
+	// one full update of a single boid from in to out.
+	// Public so benchmarks and validation can drive it directly.
+	void processBoid(const int boid);
+
+	// neighbor rule sums for a boid of species at (x, y) moving at
+	// (vx, vy) against all of in, weighted by each species pair's
+	// strengths, with the boid itself taken back out of the alignment
+	// sum. Despawns any boids it eats. With FLOCK_ANALYTICS, edges to
+	// same-species boids with a lower index than boid are fed to flock
+	// analytics; boid = -1 feeds none.
+	void accumulateNeighbors(const int species, const float x, const float y, const float vx, const float vy, NeighborSums& sums, const int boid = -1);
+
 private:
-	Physics() : mouse_buttons_down(0), repulsion_boost(false), repulsion_multiplier(1.0f), threads(nullptr), in(in_arr), out(out_arr), mouse_x(0.0f), mouse_y(0.0f) {}
+	// a pool of pool_capacity boids, plus a field if with_field
+	// (FIELD_MODE). The singleton gets the full pool and a field.
+	explicit Physics(const int pool_capacity = BOID_CAPACITY, const bool with_field = true);
+
+	// the one exception to the singleton: ensembles
+	// run many independent worlds side by side
+	friend class Ensemble;
 
 	// NO copy construction or copy assignment. This is a singleton.
 	Physics(const Physics&) = delete;
 	Physics& operator=(const Physics&) = delete;
 
-	void launchThread(int start_idx, int end_idx);
+	// velocity change from the mouse for a boid at (x, y)
+	void mouseDelta(const float x, const float y, const float time_factor, float& dVx, float& dVy) const;
+
+	// store a boid's new state and draw data
+	void storeBoid(Boid& b, const int species, float x, float y, float Vx, float Vy) const;
+
+	// per-step work before and after the boids are processed
+	void beginStep();
+	void endStep();
+
+	// survivors of chunk of chunks into compact_offsets[chunk]
+	void countSurvivors(const int chunk, const int chunks);
+
+	// survivors of chunk of chunks from out to in, from compact_offsets[chunk]
+	void moveSurvivors(const int chunk, const int chunks);
+
+	// recompute species_start from in
+	void updateSpeciesRanges();
 
 };
 
@@ -0,0 +1,301 @@
+/*******************************************************************
+*   Boids3D.cpp
+*   Boids
+*	agent
+*
+*	10/19/2026
+*******************************************************************/
+
+// This module contains the 3D simulation. See Boids3D.h.
+
+#include "Boids3D.h"
+
+// wrapped neighbor cells must be distinct from each other and
+// from the boid's own, and one cell wide must cover NEIGHBOR_DISTANCE
+static_assert(GRID_3D_SIDE >= 3, "3D grid needs at least 3 cells per axis");
+static_assert(P_MAX / GRID_3D_SIDE >= NEIGHBOR_DISTANCE, "3D grid cells narrower than NEIGHBOR_DISTANCE");
+
+// distribution for boid initial positions
+static std::uniform_real_distribution<float> positionRandomDist3D(0.0, P_MAX);
+
+// running sums of the neighbor rules for a single boid
+struct NeighborSums3D {
+	float CMsumX, CMsumY, CMsumZ, REPsumX, REPsumY, REPsumZ, ALsumX, ALsumY, ALsumZ;
+	int neighbors;
+};
+
+// add the neighbors among boids[start, end), read as if moved by
+// (shiftx, shifty, shiftz), of a boid at (x, y, z) to sums
+static inline void accumulateRange(const Boid3D* const boids, const int start, const int end, const float x, const float y, const float z, const float shiftx, const float shifty, const float shiftz, NeighborSums3D& sums) {
+	float diffx, diffy, diffz, dist2, factor;
+
+	for (int test_boid = start; test_boid < end; ++test_boid) {
+		diffx = boids[test_boid].x + shiftx - x;
+		diffy = boids[test_boid].y + shifty - y;
+		diffz = boids[test_boid].z + shiftz - z;
+		dist2 = diffx*diffx + diffy*diffy + diffz*diffz;
+
+		// as in 2D, self is counted as a neighbor; processBoid
+		// takes it back out of the alignment sum
+		if (dist2 < NEIGHBOR_DISTANCE_SQUARED) {
+			sums.CMsumX += diffx;
+			sums.CMsumY += diffy;
+			sums.CMsumZ += diffz;
+
+			factor = 1.0f / (dist2 + PREVENT_ZERO_RETURN);
+			sums.REPsumX -= diffx * factor;
+			sums.REPsumY -= diffy * factor;
+			sums.REPsumZ -= diffz * factor;
+
+			sums.ALsumX += boids[test_boid].vx;
+			sums.ALsumY += boids[test_boid].vy;
+			sums.ALsumZ += boids[test_boid].vz;
+
+			++sums.neighbors;
+		}
+	}
+}
+
+// neighbor cell c + d along one axis, wrapping if allowed. Returns
+// false if there is no such cell; shift is the offset to the
+// nearest image of a wrapped cell.
+static inline bool neighborCell(const int c, const int d, const bool wrap, int& n, float& shift) {
+	n = c + d;
+	shift = 0.0f;
+	if (n < 0) {
+		n += GRID_3D_SIDE;
+		shift = -fP_MAX;
+		return wrap;
+	}
+	if (n >= GRID_3D_SIDE) {
+		n -= GRID_3D_SIDE;
+		shift = fP_MAX;
+		return wrap;
+	}
+	return true;
+}
+
+// shortest signed distance from c1 to c2 along an axis
+static inline float axisDiff(const float c1, const float c2, const bool wrap) {
+	float d = c2 - c1;
+	if (wrap) d += fP_MAX*((d < -fHALF_P_MAX) - (d > fHALF_P_MAX));
+	return d;
+}
+
+// repulsion off the faces of a non-wrapping axis
+static inline float edgeRepulsion(const SimParams& params, const float c) {
+	return params.repulsion * (params.edge_repulsion*(c < NEIGHBOR_DISTANCE)*(NEIGHBOR_DISTANCE - c) - params.edge_repulsion*(c > fP_MAX - NEIGHBOR_DISTANCE)*(c - (fP_MAX - NEIGHBOR_DISTANCE)));
+}
+
+// move along one axis, wrapping or bouncing as in 2D
+static inline void moveAxis(float& c, float& v, const bool wrap, const float time_factor) {
+	if (wrap) {
+		c += v * time_factor;
+		c += fP_MAX*((c < 0.0f) - (c >= fP_MAX));
+	}
+	else {
+		if (c < 0.0f) v = fabs(v);
+		if (c >= fP_MAX) v = -fabs(v);
+		c += v * time_factor;
+	}
+}
+
+int Physics3D::cellOf(const float x, const float y, const float z) const {
+	// positions on a bouncing axis can be just outside the cube;
+	// they belong to the edge cell, which still covers their neighbors
+	const int cx = std::min(std::max(static_cast<int>(x * (GRID_3D_SIDE / fP_MAX)), 0), GRID_3D_SIDE - 1);
+	const int cy = std::min(std::max(static_cast<int>(y * (GRID_3D_SIDE / fP_MAX)), 0), GRID_3D_SIDE - 1);
+	const int cz = std::min(std::max(static_cast<int>(z * (GRID_3D_SIDE / fP_MAX)), 0), GRID_3D_SIDE - 1);
+
+	// far (high z) cells first, for back to front drawing
+	return ((GRID_3D_SIDE - 1 - cz) * GRID_3D_SIDE + cy) * GRID_3D_SIDE + cx;
+}
+
+void Physics3D::project(const float x, const float y, const float z, float& sx, float& sy) const {
+	// the near face (z = 0) fills the screen
+	const float persp = CAMERA_3D_DISTANCE / (CAMERA_3D_DISTANCE + z);
+	sx = fWidth * (0.5f + (x - fHALF_P_MAX) * persp / fP_MAX);
+	sy = fHeight * (0.5f + (y - fHALF_P_MAX) * persp / fP_MAX);
+}
+
+void Physics3D::storeBoid(Boid3D& b, const float x, const float y, const float z, const float Vx, const float Vy, const float Vz) const {
+	float sx1, sy1, sx2, sy2;
+
+	b.x = x;
+	b.y = y;
+	b.z = z;
+	b.vx = Vx;
+	b.vy = Vy;
+	b.vz = Vz;
+
+	// project a segment along the velocity, as long in simulation
+	// units as a 2D boid's line is on screen, so boids heading
+	// toward or away from the camera are foreshortened
+	const float half_length = LINE_LENGTH * fP_MAX / fWidth / (sqrt(Vx*Vx + Vy*Vy + Vz*Vz) + PREVENT_ZERO_RETURN);
+	project(x - half_length * Vx, y - half_length * Vy, z - half_length * Vz, sx1, sy1);
+	project(x + half_length * Vx, y + half_length * Vy, z + half_length * Vz, sx2, sy2);
+
+	b.draw_x1 = static_cast<int>(sx1 + 0.5f);
+	b.draw_y1 = static_cast<int>(sy1 + 0.5f);
+	b.draw_x2 = static_cast<int>(sx2 + 0.5f);
+	b.draw_y2 = static_cast<int>(sy2 + 0.5f);
+
+	// fade toward the far face
+	const float shade = 1.0f - (1.0f - DEPTH_SHADE_3D_MIN) * std::min(std::max(z / fP_MAX, 0.0f), 1.0f);
+
+#ifdef DYNAMIC_COLOR_MODE
+	// color by on-screen direction of travel, as in 2D
+	const RGB color = angleToRGB(atan2f(sx2 - sx1, sy2 - sy1) + fPI);
+	b.R = static_cast<uint8_t>(shade * color.R);
+	b.G = static_cast<uint8_t>(shade * color.G);
+	b.B = static_cast<uint8_t>(shade * color.B);
+#else
+	const uint8_t color[3] = { BOID_COLOR_IF_NOT_DYNAMIC_MODE };
+	b.R = static_cast<uint8_t>(shade * color[0]);
+	b.G = static_cast<uint8_t>(shade * color[1]);
+	b.B = static_cast<uint8_t>(shade * color[2]);
+#endif
+}
+
+void Physics3D::processBoid(const int boid) {
+	float x, y, z, Vx, Vy, Vz, magVsquared;
+	float time_factor, factor, diffx, diffy, diffz;
+	float shiftx, shifty, shiftz;
+	int nx, ny, nz, row;
+	NeighborSums3D sums = {};
+
+	// bring boid's position and velocity local
+	x = in[boid].x;
+	y = in[boid].y;
+	z = in[boid].z;
+	Vx = in[boid].vx;
+	Vy = in[boid].vy;
+	Vz = in[boid].vz;
+
+	time_factor = params.tick_factor * time_since_last_frame;
+
+	// mouse attraction/repulsion, toward the mouse on the mid-depth plane
+	if (mouse_buttons_down) {
+		diffx = axisDiff(x, mouse_sim_x, wrap[0]);
+		diffy = axisDiff(y, mouse_sim_y, wrap[1]);
+		diffz = axisDiff(z, fHALF_P_MAX, wrap[2]);
+		factor = time_factor * (repulsion_multiplier * ((repulsion_boost) ? params.strong_mouse : params.weak_mouse)) / (sqrt(diffx * diffx + diffy * diffy + diffz * diffz) + PREVENT_ZERO_RETURN);
+		Vx += diffx * factor;
+		Vy += diffy * factor;
+		Vz += diffz * factor;
+	}
+
+	// own cell coordinates, recovered from its index
+	const int cell = cellOf(x, y, z);
+	const int cx = cell % GRID_3D_SIDE;
+	const int cy = cell / GRID_3D_SIDE % GRID_3D_SIDE;
+	const int cz = GRID_3D_SIDE - 1 - cell / (GRID_3D_SIDE * GRID_3D_SIDE);
+
+	// neighbors are all in the 27 surrounding cells
+	for (int dz = -1; dz <= 1; ++dz) {
+		if (!neighborCell(cz, dz, wrap[2], nz, shiftz)) continue;
+		for (int dy = -1; dy <= 1; ++dy) {
+			if (!neighborCell(cy, dy, wrap[1], ny, shifty)) continue;
+			row = ((GRID_3D_SIDE - 1 - nz) * GRID_3D_SIDE + ny) * GRID_3D_SIDE;
+
+			// away from the x faces, the row's 3 cells are one range
+			if (cx > 0 && cx < GRID_3D_SIDE - 1) {
+				accumulateRange(in, cell_start[row + cx - 1], cell_start[row + cx + 2], x, y, z, 0.0f, shifty, shiftz, sums);
+				continue;
+			}
+
+			for (int dx = -1; dx <= 1; ++dx) {
+				if (!neighborCell(cx, dx, wrap[0], nx, shiftx)) continue;
+				accumulateRange(in, cell_start[row + nx], cell_start[row + nx + 1], x, y, z, shiftx, shifty, shiftz, sums);
+			}
+		}
+	}
+
+	// take ourselves back out of the alignment sum
+	sums.ALsumX -= in[boid].vx;
+	sums.ALsumY -= in[boid].vy;
+	sums.ALsumZ -= in[boid].vz;
+
+	// combine the rules as in 2D, with edge repulsion on bouncing axes
+	Vx += time_factor * (params.center_of_mass * sums.CMsumX / sums.neighbors + params.repulsion * sums.REPsumX + params.alignment * sums.ALsumX / sums.neighbors + (wrap[0] ? 0.0f : edgeRepulsion(params, x)));
+	Vy += time_factor * (params.center_of_mass * sums.CMsumY / sums.neighbors + params.repulsion * sums.REPsumY + params.alignment * sums.ALsumY / sums.neighbors + (wrap[1] ? 0.0f : edgeRepulsion(params, y)));
+	Vz += time_factor * (params.center_of_mass * sums.CMsumZ / sums.neighbors + params.repulsion * sums.REPsumZ + params.alignment * sums.ALsumZ / sums.neighbors + (wrap[2] ? 0.0f : edgeRepulsion(params, z)));
+
+	// limit velocity if over v_lim
+	magVsquared = Vx*Vx + Vy*Vy + Vz*Vz;
+	factor = (magVsquared > params.v_lim * params.v_lim) ? params.v_lim / sqrt(magVsquared) : 1.0f;
+	Vx *= factor;
+	Vy *= factor;
+	Vz *= factor;
+
+	moveAxis(x, Vx, wrap[0], time_factor);
+	moveAxis(y, Vy, wrap[1], time_factor);
+	moveAxis(z, Vz, wrap[2], time_factor);
+
+	storeBoid(out[boid], x, y, z, Vx, Vy, Vz);
+}
+
+void Physics3D::refreshDrawData() {
+	for (int boid = 0; boid < num_boids; ++boid) storeBoid(in[boid], in[boid].x, in[boid].y, in[boid].z, in[boid].vx, in[boid].vy, in[boid].vz);
+}
+
+void Physics3D::sortIntoGrid() {
+	int i;
+
+	// counting sort by cell, from in into out. Linear and cheap
+	// next to the step, so serial.
+	std::fill(cell_start, cell_start + GRID_3D_CELLS + 1, 0);
+	for (i = 0; i < num_boids; ++i) ++cell_start[cellOf(in[i].x, in[i].y, in[i].z) + 1];
+	for (i = 1; i <= GRID_3D_CELLS; ++i) cell_start[i] += cell_start[i - 1];
+
+	// place each boid at its cell's next free slot, which leaves
+	// cell_start[c] at the end of cell c, i.e. the start of c + 1...
+	for (i = 0; i < num_boids; ++i) out[cell_start[cellOf(in[i].x, in[i].y, in[i].z)]++] = in[i];
+
+	// ...so shift it back
+	for (i = GRID_3D_CELLS; i > 0; --i) cell_start[i] = cell_start[i - 1];
+	cell_start[0] = 0;
+
+	swapBuffers();
+}
+
+void Physics3D::seedRNG(const unsigned int seed) {
+	gen.seed(seed);
+}
+
+void Physics3D::spawnBoids() {
+	for (int i = 0; i < num_boids; ++i) {
+		in[i].vx = in[i].vy = in[i].vz = 0.0f;
+
+		in[i].x = positionRandomDist3D(gen);
+		in[i].y = positionRandomDist3D(gen);
+		in[i].z = positionRandomDist3D(gen);
+	}
+
+	step_count = 0;
+	sim_time = 0.0;
+}
+
+void Physics3D::swapBuffers() {
+	Boid3D* temp = in;
+	in = out;
+	out = temp;
+}
+
+void Physics3D::processRules() {
+	sortIntoGrid();
+
+	// the mouse's screen position, unprojected onto the mid-depth plane
+	const float persp = CAMERA_3D_DISTANCE / (CAMERA_3D_DISTANCE + fHALF_P_MAX);
+	mouse_sim_x = fHALF_P_MAX + (mouse_x / fWidth - 0.5f) * fP_MAX / persp;
+	mouse_sim_y = fHALF_P_MAX + (mouse_y / fHeight - 0.5f) * fP_MAX / persp;
+
+	// boids are in grid order, so each chunk is a compact block
+	// of space whose neighbor cells are shared and stay in cache
+	schedule(num_boids, [this](const int start_idx, const int end_idx) {
+		for (int boid = start_idx; boid <= end_idx; ++boid) processBoid(boid);
+	});
+
+	++step_count;
+	sim_time += time_since_last_frame;
+}
@@ -0,0 +1,141 @@
+/*******************************************************************
+*   Boids3D.h
+*   Boids
+*	agent
+*
+*	10/19/2026
+*******************************************************************/
+
+// This module contains the 3D simulation: the same rules as
+// Physics, for boids in a P_MAX cube, each axis independently
+// wrapping or bouncing off its faces. main runs it in place of
+// Physics with MODE_3D defined.
+//
+// Naive neighbor search would be hopeless in 3D, so every step
+// begins by counting-sorting in into a uniform grid of cells at
+// least NEIGHBOR_DISTANCE wide. A boid's neighbors are then all in
+// the 27 cells around its own, each a contiguous range of in, and
+// boids processed together read the same cells. Wrapped neighbor
+// cells are offset by a whole P_MAX as they're read, so the
+// distance math never branches on wrap.
+//
+// For drawing, each boid is projected through a perspective
+// camera looking down z and shaded darker with depth. Cells are
+// numbered far to near, so drawing in array order is also drawing
+// (to within a cell) back to front.
+
+#ifndef BOIDS3D_H
+#define BOIDS3D_H
+
+#include "Boids.h"
+
+// grid cells per axis; each at least NEIGHBOR_DISTANCE wide
+#define GRID_3D_SIDE		(P_MAX / NEIGHBOR_DISTANCE)
+#define GRID_3D_CELLS		(GRID_3D_SIDE * GRID_3D_SIDE * GRID_3D_SIDE)
+
+struct Boid3D {
+	float x, y, z, vx, vy, vz;
+
+	// depth-shaded color
+	uint8_t R, G, B;
+
+	int draw_x1, draw_y1, draw_x2, draw_y2;
+};
+
+class Physics3D : public Scheduler {
+public:
+	int last_total_time = 0;
+
+	float time_since_last_frame;
+	int mouse_x = 0, mouse_y = 0;
+
+	int mouse_buttons_down = 0;
+	float repulsion_multiplier = 1.0f;
+	bool repulsion_boost = false;
+
+	SimParams params;
+
+	// at most BOID_CAPACITY
+	int num_boids = NUMBER_OF_BOIDS;
+
+	bool not_paused = true;
+
+	// completed steps and simulated milliseconds since spawn
+	uint64_t step_count = 0;
+	double sim_time = 0.0;
+
+	float fWidth, fHeight;
+
+	// per axis (x, y, z): wrap, or bounce off the faces
+	bool wrap[3];
+
+	Boid3D in_arr[BOID_CAPACITY];
+	Boid3D out_arr[BOID_CAPACITY];
+
+	Boid3D* in;
+	Boid3D* out;
+
+	// random number generator for boid initial positions
+	std::mt19937 gen;
+
+private:
+	// in[cell_start[c], cell_start[c + 1]) are in grid cell c
+	int cell_start[GRID_3D_CELLS + 1];
+
+	// mouse in simulation coordinates, on the z = fHALF_P_MAX plane
+	float mouse_sim_x, mouse_sim_y;
+
+public:
+	// Singleton idiom, as Physics
+	static Physics3D& getInstance() {
+		static Physics3D instance;
+		return instance;
+	};
+
+	// reseed the generator, for reproducible spawns
+	void seedRNG(const unsigned int seed);
+
+	void spawnBoids();
+
+	// sort in into the grid, then step every boid from in to out
+	void processRules();
+
+	// ping-pong in and out after a step
+	void swapBuffers();
+
+	// recompute in's draw data, to show state that
+	// didn't come out of a step (e.g. a respawn while paused)
+	void refreshDrawData();
+
+	// one full update of a single boid from in to out. Public so
+	// benchmarks and validation can drive it directly, after
+	// processRules (or sortIntoGrid) has sorted in.
+	void processBoid(const int boid);
+
+	// counting sort in into the grid via out, and swap
+	void sortIntoGrid();
+
+private:
+	Physics3D() : in(in_arr), out(out_arr), gen(std::random_device()()) {
+#ifdef SCREEN_WRAP
+		wrap[0] = wrap[1] = wrap[2] = true;
+#else
+		wrap[0] = wrap[1] = wrap[2] = false;
+#endif
+	}
+
+	// NO copy construction or copy assignment. This is a singleton.
+	Physics3D(const Physics3D&) = delete;
+	Physics3D& operator=(const Physics3D&) = delete;
+
+	// grid cell of a position, clamped to the grid
+	int cellOf(const float x, const float y, const float z) const;
+
+	// screen position of a point in simulation coordinates
+	void project(const float x, const float y, const float z, float& sx, float& sy) const;
+
+	// store a boid's new state and draw data
+	void storeBoid(Boid3D& b, const float x, const float y, const float z, const float Vx, const float Vy, const float Vz) const;
+};
+
+#endif
@@ -0,0 +1,267 @@
+/*******************************************************************
+*   Checkpoint.cpp
+*   Boids
+*	agent
+*
+*	10/19/2026
+*******************************************************************/
+
+// This module contains checkpoint save/restore of the full
+// simulation state. See Checkpoint.h.
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Checkpoint.h"
+
+static_assert(sizeof(CheckpointHeader) == 80, "CheckpointHeader layout changed; bump CHECKPOINT_VERSION");
+static_assert(sizeof(CheckpointRecord) == 20, "CheckpointRecord layout changed; bump CHECKPOINT_VERSION");
+
+static const char* const PARAM_NAMES[CHECKPOINT_NUM_PARAMS] = {
+	"V_LIM", "TICK_FACTOR", "ALIGNMENT_STRENGTH_FACTOR", "REPULSION_STRENGTH_FACTOR", "EDGE_REPULSION_STRENGTH_FACTOR",
+	"CENTER_OF_MASS_STRENGTH_FACTOR", "NEIGHBOR_DISTANCE", "P_MAX", "SCREEN_WRAP"
+};
+
+static void currentParams(const Physics& physics, float* const params) {
+	params[0] = physics.params.v_lim;
+	params[1] = physics.params.tick_factor;
+	params[2] = physics.params.alignment;
+	params[3] = physics.params.repulsion;
+	params[4] = physics.params.edge_repulsion;
+	params[5] = physics.params.center_of_mass;
+	params[6] = NEIGHBOR_DISTANCE;
+	params[7] = P_MAX;
+#ifdef SCREEN_WRAP
+	params[8] = 1.0f;
+#else
+	params[8] = 0.0f;
+#endif
+}
+
+// read-only memory mapping of a whole file
+class MappedFile {
+public:
+	const char* data;
+	size_t size;
+
+	explicit MappedFile(const std::string& path) : data(nullptr), size(0) {
+#ifdef _WIN32
+		file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		mapping = nullptr;
+		if (file == INVALID_HANDLE_VALUE) return;
+
+		LARGE_INTEGER len;
+		if (!GetFileSizeEx(file, &len) || !len.QuadPart) return;
+
+		if (!(mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr))) return;
+		if ((data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)))) size = static_cast<size_t>(len.QuadPart);
+#else
+		fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0) return;
+
+		struct stat st;
+		if (fstat(fd, &st) || !st.st_size) return;
+
+		void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p == MAP_FAILED) return;
+
+		data = static_cast<const char*>(p);
+		size = static_cast<size_t>(st.st_size);
+#endif
+	}
+
+	~MappedFile() {
+#ifdef _WIN32
+		if (data) UnmapViewOfFile(data);
+		if (mapping) CloseHandle(mapping);
+		if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+		if (data) munmap(const_cast<char*>(data), size);
+		if (fd >= 0) close(fd);
+#endif
+	}
+
+private:
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+#ifdef _WIN32
+	HANDLE file, mapping;
+#else
+	int fd;
+#endif
+};
+
+bool Checkpointer::saveAsync(const Physics& physics, const std::string& path) {
+	// never stall the sim waiting on the disk;
+	// just skip this save if the last one is still going
+	if (busy) return false;
+	if (writer.joinable()) writer.join();
+
+	std::stringstream rng;
+	rng << physics.gen;
+	const std::string rng_state = rng.str();
+
+	CheckpointHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = CHECKPOINT_MAGIC;
+	header.version = CHECKPOINT_VERSION;
+	header.header_size = sizeof(CheckpointHeader);
+	header.record_size = sizeof(CheckpointRecord);
+	header.num_boids = physics.num_boids;
+	header.rng_state_size = static_cast<uint32_t>(rng_state.size());
+	header.step_count = physics.step_count;
+	header.sim_time = physics.sim_time;
+	currentParams(physics, header.params);
+
+	// serialize here, on the calling thread, so the sim is free
+	// to overwrite its buffers as soon as we return
+	buffer.resize(sizeof(header) + rng_state.size() + physics.num_boids * sizeof(CheckpointRecord));
+	char* p = buffer.data();
+	memcpy(p, &header, sizeof(header));
+	p += sizeof(header);
+	memcpy(p, rng_state.data(), rng_state.size());
+	p += rng_state.size();
+
+	CheckpointRecord r;
+	for (int i = 0; i < physics.num_boids; ++i, p += sizeof(r)) {
+		r.x = physics.in[i].x;
+		r.y = physics.in[i].y;
+		r.vx = physics.in[i].vx;
+		r.vy = physics.in[i].vy;
+		r.species = physics.in[i].species;
+		memcpy(p, &r, sizeof(r));
+	}
+
+	busy = true;
+	writer = std::thread(&Checkpointer::writeFile, &buffer, path, &busy);
+
+	return true;
+}
+
+void Checkpointer::writeFile(const std::vector<char>* const buffer, const std::string path, std::atomic<bool>* const busy) {
+	// write to a temp file and rename over the target so
+	// a crash mid-write never leaves a torn checkpoint
+	const std::string tmp_path = path + ".tmp";
+	FILE* f = fopen(tmp_path.c_str(), "wb");
+	bool ok = f && fwrite(buffer->data(), 1, buffer->size(), f) == buffer->size();
+	if (f) ok &= !fclose(f);
+
+	if (ok) {
+#ifdef _WIN32
+		// rename won't replace an existing file on Windows
+		ok = MoveFileExA(tmp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+		// replaces path atomically, so there's always a whole checkpoint
+		ok = !rename(tmp_path.c_str(), path.c_str());
+#endif
+	}
+
+	if (!ok) std::cerr << "ERROR: unable to write checkpoint " << path << '.' << std::endl;
+
+	*busy = false;
+}
+
+bool Checkpointer::restore(Physics& physics, const std::string& path) {
+	MappedFile file(path);
+	if (!file.data) {
+		std::cerr << "ERROR: unable to map checkpoint " << path << '.' << std::endl;
+		return false;
+	}
+
+	CheckpointHeader header;
+	if (file.size < sizeof(header)) {
+		std::cerr << "ERROR: checkpoint " << path << " is truncated." << std::endl;
+		return false;
+	}
+	memcpy(&header, file.data, sizeof(header));
+
+	const bool v1 = header.version == 1u && header.record_size == CHECKPOINT_V1_RECORD_SIZE;
+	if (header.magic != CHECKPOINT_MAGIC || header.header_size != sizeof(CheckpointHeader) || (!v1 && (header.version != CHECKPOINT_VERSION || header.record_size != sizeof(CheckpointRecord)))) {
+		std::cerr << "ERROR: " << path << " is not a version 1 or " << CHECKPOINT_VERSION << " checkpoint." << std::endl;
+		return false;
+	}
+
+	if (file.size < sizeof(header) + header.rng_state_size + static_cast<size_t>(header.num_boids) * header.record_size) {
+		std::cerr << "ERROR: checkpoint " << path << " is truncated." << std::endl;
+		return false;
+	}
+
+	const char* p = file.data + sizeof(header);
+
+	// parse the RNG state aside, so a corrupt one changes nothing
+	std::mt19937 gen;
+	std::stringstream rng(std::string(p, header.rng_state_size));
+	rng >> gen;
+	if (rng.fail()) {
+		std::cerr << "ERROR: checkpoint " << path << " has a corrupt RNG state." << std::endl;
+		return false;
+	}
+	p += header.rng_state_size;
+
+	float params[CHECKPOINT_NUM_PARAMS];
+	currentParams(physics, params);
+	for (int i = 0; i < CHECKPOINT_NUM_PARAMS; ++i) {
+		if (params[i] == header.params[i]) continue;
+		if (i < CHECKPOINT_NUM_RUNTIME_PARAMS)
+			std::cout << "WARN: checkpoint " << path << " was made with " << PARAM_NAMES[i] << " = " << header.params[i] << "; resuming with that instead of " << params[i] << '.' << std::endl;
+		else
+			std::cout << "WARN: checkpoint " << path << " was made with " << PARAM_NAMES[i] << " = " << header.params[i] << ", now " << params[i] << '.' << std::endl;
+	}
+
+	if (header.num_boids > static_cast<uint32_t>(physics.capacity))
+		std::cout << "WARN: checkpoint " << path << " has " << header.num_boids << " boids; keeping the first " << physics.capacity << '.' << std::endl;
+
+	// the rules the state was produced with, e.g. a swept world's
+	physics.params.v_lim = header.params[0];
+	physics.params.tick_factor = header.params[1];
+	physics.params.alignment = header.params[2];
+	physics.params.repulsion = header.params[3];
+	physics.params.edge_repulsion = header.params[4];
+	physics.params.center_of_mass = header.params[5];
+
+	physics.gen = gen;
+	physics.discardPendingChanges();
+	physics.num_boids = std::min(static_cast<int>(header.num_boids), physics.capacity);
+	physics.step_count = header.step_count;
+	physics.sim_time = header.sim_time;
+
+	CheckpointRecord r;
+	r.species = 0;
+	int unknown_species = 0;
+	for (int i = 0; i < physics.num_boids; ++i, p += header.record_size) {
+		memcpy(&r, p, header.record_size);
+		physics.in[i].x = r.x;
+		physics.in[i].y = r.y;
+		physics.in[i].vx = r.vx;
+		physics.in[i].vy = r.vy;
+
+		// a checkpoint from a run with more species than this one
+		if (r.species >= static_cast<uint32_t>(physics.species_table.num_species)) {
+			r.species = 0;
+			++unknown_species;
+		}
+		physics.in[i].species = static_cast<uint8_t>(r.species);
+	}
+
+	if (unknown_species)
+		std::cout << "WARN: checkpoint " << path << " has " << unknown_species << " boids of species not in this run's table; they are now " << physics.species_table.species[0].name << '.' << std::endl;
+
+	physics.sortBySpecies();
+
+	return true;
+}
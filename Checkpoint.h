@@ -0,0 +1,89 @@
+/*******************************************************************
+*   Checkpoint.h
+*   Boids
+*	agent
+*
+*	10/19/2026
+*******************************************************************/
+
+// This module contains checkpoint save/restore of the full
+// simulation state (boid buffers, step count, simulated time,
+// RNG state and the parameters the state was produced with),
+// so runs and benchmarks can start from an already-formed flock
+// instead of waiting out the transient after spawnBoids.
+//
+// File layout (native endianness):
+//	CheckpointHeader
+//	rng_state_size bytes of mt19937 state, as text
+//	num_boids CheckpointRecords
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Boids.h"
+#include "params.h"
+
+// "BOID" in a little-endian file
+#define CHECKPOINT_MAGIC			(0x44494F42u)
+#define CHECKPOINT_VERSION			(2u)
+
+// version 1 records had no species; they still load, as species 0
+#define CHECKPOINT_V1_RECORD_SIZE	(16u)
+
+// parameters recorded alongside the state, in this order. The first
+// CHECKPOINT_NUM_RUNTIME_PARAMS are the SimParams rule strengths, which
+// restore puts back; the rest are compile-time and only checked. The
+// mouse strengths are interaction settings, not state, and aren't saved.
+#define CHECKPOINT_NUM_PARAMS		(9)
+#define CHECKPOINT_NUM_RUNTIME_PARAMS	(6)
+
+struct CheckpointHeader {
+	uint32_t magic, version;
+	uint32_t header_size, record_size;
+	uint32_t num_boids, rng_state_size;
+	uint64_t step_count;
+	double sim_time;
+	float params[CHECKPOINT_NUM_PARAMS];
+	uint32_t reserved;
+};
+
+struct CheckpointRecord {
+	float x, y, vx, vy;
+	uint32_t species;
+};
+
+class Checkpointer {
+public:
+	Checkpointer() : busy(false) {}
+
+	~Checkpointer() { if (writer.joinable()) writer.join(); }
+
+	// snapshot physics.in (call between steps, after the ping-pong swap)
+	// and write it to path on a background thread. Returns false without
+	// saving if the previous save is still being written.
+	bool saveAsync(const Physics& physics, const std::string& path);
+
+	// map path and load it into physics.in, along with the rule
+	// strengths it was made with. Warns, but still loads, if it was
+	// made with different compile-time parameters.
+	static bool restore(Physics& physics, const std::string& path);
+
+private:
+	// NO copy construction or copy assignment.
+	Checkpointer(const Checkpointer&) = delete;
+	Checkpointer& operator=(const Checkpointer&) = delete;
+
+	static void writeFile(const std::vector<char>* const buffer, const std::string path, std::atomic<bool>* const busy);
+
+	std::vector<char> buffer;
+	std::thread writer;
+	std::atomic<bool> busy;
+};
+
+#endif
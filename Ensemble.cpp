@@ -0,0 +1,94 @@
+/*******************************************************************
+*   Ensemble.cpp
+*   Boids
+*	agent
+*
+*	10/19/2026
+*******************************************************************/
+
+// This module contains the ensemble engine. See Ensemble.h.
+
+#include "Ensemble.h"
+
+int Ensemble::addWorld(const SimParams& params, const int num_boids, const unsigned int seed) {
+	const int n = std::max(1, std::min(num_boids, BOID_CAPACITY));
+
+	// sized to its population, with no field: a world never
+	// grows and has no obstacles, so many small ones stay small
+	std::unique_ptr<Physics> world(new Physics(n, false));
+
+	world->params = params;
+	world->num_boids = n;
+
+	// headless: draw coordinates are computed but unused
+	world->fWidth = world->fHeight = fP_MAX;
+
+	// the ensemble does the threading
+	world->num_CPU = 1;
+
+	world->seedRNG(seed);
+	world->spawnBoids();
+
+	worlds.push_back(std::move(world));
+	return size() - 1;
+}
+
+void Ensemble::processRange(int start_idx, const int end_idx) {
+	// last world starting at or before start_idx
+	int w = static_cast<int>(std::upper_bound(offsets.begin(), offsets.end() - 1, start_idx) - offsets.begin()) - 1;
+
+	for (; start_idx <= end_idx; ++w) {
+		Physics& world = *worlds[w];
+		const int stop = std::min(end_idx, offsets[w + 1] - 1);
+		for (int i = start_idx; i <= stop; ++i) world.processBoid(i - offsets[w]);
+		start_idx = std::max(start_idx, stop + 1);
+	}
+}
+
+void Ensemble::step(const float dt_ms) {
+	if (!threads) initThreads();
+
+	offsets.assign(1, 0);
+	for (std::unique_ptr<Physics>& world : worlds) {
+		world->time_since_last_frame = dt_ms;
+		world->beginStep();
+		offsets.push_back(offsets.back() + world->num_boids);
+	}
+
+	// same schedule as Physics::processRules, over every world at once
+	schedule(offsets.back(), [this](const int start_idx, const int end_idx) { processRange(start_idx, end_idx); });
+
+	// linear in boids, so cheap next to the step; left serial
+	for (std::unique_ptr<Physics>& world : worlds) {
+		world->endStep();
+		world->swapBuffers();
+	}
+}
+
+void Ensemble::measureFlocks(const int w, FlockStats& stats) {
+	const Physics& world = *worlds[w];
+	float diffx, diffy;
+
+	// flocks are single-species components of the neighbor graph,
+	// as the kernel builds it for FLOCK_ANALYTICS
+	flocks.reset(world.num_boids);
+	for (int s = 0; s < world.species_table.num_species; ++s) {
+		const float range = world.species_table.pairs[s][s].range * NEIGHBOR_DISTANCE;
+		const float range_squared = range * range;
+		const int start = world.species_start[s], end = world.species_start[s + 1];
+
+		for (int i = start; i < end; ++i) {
+			for (int j = start; j < i; ++j) {
+				diffx = fabs(world.in[j].x - world.in[i].x);
+				diffy = fabs(world.in[j].y - world.in[i].y);
+#ifdef SCREEN_WRAP
+				diffx = std::min(diffx, fP_MAX - diffx);
+				diffy = std::min(diffy, fP_MAX - diffy);
+#endif
+				if (diffx * diffx + diffy * diffy < range_squared) flocks.unite(i, j);
+			}
+		}
+	}
+
+	flocks.finalize(world.in, world.num_boids, stats);
+}
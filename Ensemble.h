@@ -0,0 +1,65 @@
+/*******************************************************************
+*   Ensemble.h
+*   Boids
+*	agent
+*
+*	10/19/2026
+*******************************************************************/
+
+// This module contains the ensemble engine: many independent worlds
+// (Physics instances, each with its own SimParams, population and
+// seed) stepped together in one process, for parameter sweeps
+// without a rebuild per setting. Rather than give each world its own
+// threads, every step flattens all worlds' boids into one index range
+// and hands it out to one set of threads with the same Scheduler as
+// Physics, so many small worlds still keep every core busy. sweep.cpp is the headless driver.
+
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+#include <memory>
+#include <vector>
+
+#include "Analytics.h"
+#include "Boids.h"
+#include "Scheduler.h"
+
+class Ensemble : public Scheduler {
+public:
+	Ensemble() {}
+
+	// add a freshly spawned world and return its index.
+	// num_boids is clamped to 1..BOID_CAPACITY, and is also
+	// the world's pool size; worlds have no field.
+	int addWorld(const SimParams& params, const int num_boids, const unsigned int seed);
+
+	// advance every world by one step of dt_ms
+	void step(const float dt_ms);
+
+	// flock stats of world w's current state, found by a neighbor
+	// search of its own rather than in the kernel, so they're there
+	// without FLOCK_ANALYTICS (but cost about a step each)
+	void measureFlocks(const int w, FlockStats& stats);
+
+	int size() const { return static_cast<int>(worlds.size()); }
+
+	Physics& world(const int i) { return *worlds[i]; }
+
+private:
+	// NO copy construction or copy assignment.
+	Ensemble(const Ensemble&) = delete;
+	Ensemble& operator=(const Ensemble&) = delete;
+
+	// process flat indices start_idx..end_idx, which may span worlds
+	void processRange(int start_idx, const int end_idx);
+
+	std::vector<std::unique_ptr<Physics>> worlds;
+
+	// flat index of each world's first boid, plus the total at the end
+	std::vector<int> offsets;
+
+	// scratch for measureFlocks
+	FlockAnalytics flocks;
+};
+
+#endif
@@ -0,0 +1,244 @@
+/*******************************************************************
+*   Field.cpp
+*   Boids
+*	agent
+*
+*	10/19/2026
+*******************************************************************/
+
+// This module contains the precomputed obstacle and attractor
+// force field. See Field.h.
+
+#include "Boids.h"
+#include "Field.h"
+
+#ifdef FIELD_MODE
+
+// stand-in for infinite squared distance in the distance transform
+#define EDT_INF (1e20f)
+
+// 1D squared Euclidean distance transform of f (Felzenszwalb & Huttenlocher),
+// written to d. v and z are scratch space of at least n and n + 1 entries.
+static void edt1D(const float* const f, float* const d, const int n, int* const v, float* const z) {
+	int k = 0;
+	v[0] = 0;
+	z[0] = -EDT_INF;
+	z[1] = EDT_INF;
+
+	float s;
+	for (int q = 1; q < n; ++q) {
+		// z[0] is -EDT_INF, so this always terminates with k >= 0
+		for (;;) {
+			s = ((f[q] + q*q) - (f[v[k]] + v[k] * v[k])) / (2.0f * (q - v[k]));
+			if (s > z[k]) break;
+			--k;
+		}
+		++k;
+		v[k] = q;
+		z[k] = s;
+		z[k + 1] = EDT_INF;
+	}
+
+	k = 0;
+	for (int q = 0; q < n; ++q) {
+		while (z[k + 1] < q) ++k;
+		d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+	}
+}
+
+// 2D squared distance transform (in cells) from every cell to the nearest
+// cell where is_feature(cell) holds. With SCREEN_WRAP the domain is periodic,
+// which we get by transforming each line tiled 3 times and keeping the middle.
+template <typename Pred>
+static void edt2D(float* const out, Pred is_feature) {
+#ifdef SCREEN_WRAP
+	const int n = 3 * FIELD_RESOLUTION;
+	const int offset = FIELD_RESOLUTION;
+#else
+	const int n = FIELD_RESOLUTION;
+	const int offset = 0;
+#endif
+	std::vector<float> f(n), d(n), z(n + 1);
+	std::vector<int> v(n);
+
+	// rows
+	for (int j = 0; j < FIELD_RESOLUTION; ++j) {
+		for (int q = 0; q < n; ++q)
+			f[q] = is_feature(j * FIELD_RESOLUTION + q % FIELD_RESOLUTION) ? 0.0f : EDT_INF;
+		edt1D(f.data(), d.data(), n, v.data(), z.data());
+		for (int i = 0; i < FIELD_RESOLUTION; ++i)
+			out[j * FIELD_RESOLUTION + i] = d[i + offset];
+	}
+
+	// columns
+	for (int i = 0; i < FIELD_RESOLUTION; ++i) {
+		for (int q = 0; q < n; ++q)
+			f[q] = out[(q % FIELD_RESOLUTION) * FIELD_RESOLUTION + i];
+		edt1D(f.data(), d.data(), n, v.data(), z.data());
+		for (int j = 0; j < FIELD_RESOLUTION; ++j)
+			out[j * FIELD_RESOLUTION + i] = d[j + offset];
+	}
+}
+
+// neighboring cell index along one axis, wrapped or clamped
+static inline int neighborCell(const int i) {
+#ifdef SCREEN_WRAP
+	return i & (FIELD_RESOLUTION - 1);
+#else
+	return std::min(std::max(i, 0), FIELD_RESOLUTION - 1);
+#endif
+}
+
+Field::Field() : mask_changed(false), obstacles_dirty(false), combine_dirty(false) {
+	static_assert((FIELD_RESOLUTION & (FIELD_RESOLUTION - 1)) == 0, "FIELD_RESOLUTION must be a power of 2");
+
+	std::fill(force_x, force_x + FIELD_CELLS, 0.0f);
+	std::fill(force_y, force_y + FIELD_CELLS, 0.0f);
+	std::fill(obstacle_fx, obstacle_fx + FIELD_CELLS, 0.0f);
+	std::fill(obstacle_fy, obstacle_fy + FIELD_CELLS, 0.0f);
+	std::fill(attractor_fx, attractor_fx + FIELD_CELLS, 0.0f);
+	std::fill(attractor_fy, attractor_fy + FIELD_CELLS, 0.0f);
+	std::fill(obstacle_mask, obstacle_mask + FIELD_CELLS, uint8_t(0));
+}
+
+void Field::addObstacleDisc(const float x, const float y, const float r) {
+	float cx, cy, dx, dy;
+	const float r2 = r * r;
+
+	for (int j = 0; j < FIELD_RESOLUTION; ++j) {
+		cy = (j + 0.5f) * fFIELD_CELL_SIZE;
+		for (int i = 0; i < FIELD_RESOLUTION; ++i) {
+			cx = (i + 0.5f) * fFIELD_CELL_SIZE;
+#ifdef SCREEN_WRAP
+			dx = fastdiff(x, cx);
+			dy = fastdiff(y, cy);
+#else
+			dx = cx - x;
+			dy = cy - y;
+#endif
+			if (dx*dx + dy*dy < r2) obstacle_mask[j * FIELD_RESOLUTION + i] = 1;
+		}
+	}
+
+	obstacles_dirty = mask_changed = true;
+}
+
+void Field::addObstacleMask(const uint8_t* const mask, const int w, const int h) {
+	// nearest-neighbor resample onto the grid
+	for (int j = 0; j < FIELD_RESOLUTION; ++j) {
+		const uint8_t* row = mask + (j * h / FIELD_RESOLUTION) * w;
+		for (int i = 0; i < FIELD_RESOLUTION; ++i) {
+			if (row[i * w / FIELD_RESOLUTION]) obstacle_mask[j * FIELD_RESOLUTION + i] = 1;
+		}
+	}
+
+	obstacles_dirty = mask_changed = true;
+}
+
+void Field::clearObstacles() {
+	std::fill(obstacle_mask, obstacle_mask + FIELD_CELLS, uint8_t(0));
+	obstacles_dirty = mask_changed = true;
+}
+
+void Field::addAttractor(const float x, const float y, const float strength) {
+	attractors.emplace_back(x, y, strength);
+
+	// attractors superpose, so a new one is just added on top
+	// without touching any of the others
+	accumulateAttractor(attractors.back());
+	combine_dirty = true;
+}
+
+void Field::clearAttractors() {
+	attractors.clear();
+	std::fill(attractor_fx, attractor_fx + FIELD_CELLS, 0.0f);
+	std::fill(attractor_fy, attractor_fy + FIELD_CELLS, 0.0f);
+	combine_dirty = true;
+}
+
+void Field::accumulateAttractor(const Attractor& a) {
+	float cx, cy, diffx, diffy, factor;
+
+	for (int j = 0; j < FIELD_RESOLUTION; ++j) {
+		cy = (j + 0.5f) * fFIELD_CELL_SIZE;
+		for (int i = 0; i < FIELD_RESOLUTION; ++i) {
+			cx = (i + 0.5f) * fFIELD_CELL_SIZE;
+#ifdef SCREEN_WRAP
+			diffx = diff(cx, a.x);
+			diffy = diff(cy, a.y);
+#else
+			diffx = a.x - cx;
+			diffy = a.y - cy;
+#endif
+			// same model as mouse attraction: constant magnitude,
+			// pointing at the attractor
+			factor = a.strength / (sqrt(diffx * diffx + diffy * diffy) + PREVENT_ZERO_RETURN);
+			attractor_fx[j * FIELD_RESOLUTION + i] += diffx * factor;
+			attractor_fy[j * FIELD_RESOLUTION + i] += diffy * factor;
+		}
+	}
+}
+
+void Field::rebuildObstacles() {
+	bool any_obstacle = std::find(obstacle_mask, obstacle_mask + FIELD_CELLS, 1) != obstacle_mask + FIELD_CELLS;
+	if (!any_obstacle) {
+		std::fill(obstacle_fx, obstacle_fx + FIELD_CELLS, 0.0f);
+		std::fill(obstacle_fy, obstacle_fy + FIELD_CELLS, 0.0f);
+		return;
+	}
+
+	// signed distance (in cells) to the obstacle boundary:
+	// positive outside obstacles, negative inside, so its
+	// gradient points away from the nearest obstacle everywhere
+	std::vector<float> outside(FIELD_CELLS), inside(FIELD_CELLS);
+	edt2D(outside.data(), [this](const int c) { return obstacle_mask[c] != 0; });
+	edt2D(inside.data(), [this](const int c) { return obstacle_mask[c] == 0; });
+
+	std::vector<float> sd(FIELD_CELLS);
+	for (int c = 0; c < FIELD_CELLS; ++c) sd[c] = sqrt(outside[c]) - sqrt(inside[c]);
+
+	const float influence = FIELD_INFLUENCE_DISTANCE * fFIELD_INV_CELL_SIZE;
+	float gx, gy, mag, falloff;
+	int c;
+
+	for (int j = 0; j < FIELD_RESOLUTION; ++j) {
+		for (int i = 0; i < FIELD_RESOLUTION; ++i) {
+			c = j * FIELD_RESOLUTION + i;
+
+			// linear falloff squared outside, full strength inside
+			falloff = (sd[c] <= 0.0f) ? 1.0f : std::max(1.0f - sd[c] / influence, 0.0f);
+			falloff *= falloff;
+
+			if (falloff == 0.0f) {
+				obstacle_fx[c] = obstacle_fy[c] = 0.0f;
+				continue;
+			}
+
+			// central difference gradient of signed distance
+			gx = sd[j * FIELD_RESOLUTION + neighborCell(i + 1)] - sd[j * FIELD_RESOLUTION + neighborCell(i - 1)];
+			gy = sd[neighborCell(j + 1) * FIELD_RESOLUTION + i] - sd[neighborCell(j - 1) * FIELD_RESOLUTION + i];
+			mag = FIELD_OBSTACLE_STRENGTH_FACTOR * falloff / (sqrt(gx*gx + gy*gy) + PREVENT_ZERO_RETURN);
+
+			obstacle_fx[c] = gx * mag;
+			obstacle_fy[c] = gy * mag;
+		}
+	}
+}
+
+void Field::update() {
+	if (obstacles_dirty) {
+		rebuildObstacles();
+		obstacles_dirty = false;
+		combine_dirty = true;
+	}
+
+	if (combine_dirty) {
+		for (int c = 0; c < FIELD_CELLS; ++c) {
+			force_x[c] = obstacle_fx[c] + attractor_fx[c];
+			force_y[c] = obstacle_fy[c] + attractor_fy[c];
+		}
+		combine_dirty = false;
+	}
+}
+
+#endif
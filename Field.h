@@ -0,0 +1,131 @@
+/*******************************************************************
+*   Field.h
+*   Boids
+*	agent
+*
+*	10/19/2026
+*******************************************************************/
+
+// This module contains the precomputed obstacle and attractor
+// force field. Obstacles (walls, discs, shapes loaded from a bitmap)
+// and point attractors/repulsors are baked into a FIELD_RESOLUTION^2
+// grid over the P_MAX square whenever they change. The physics kernel
+// then takes a single bilinear sample per boid, so per-boid cost is
+// O(1) no matter how many obstacles or attractors exist.
+
+#ifndef FIELD_H
+#define FIELD_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "params.h"
+
+#define FIELD_CELLS					(FIELD_RESOLUTION * FIELD_RESOLUTION)
+#define fFIELD_CELL_SIZE			(fP_MAX / FIELD_RESOLUTION)
+#define fFIELD_INV_CELL_SIZE		(FIELD_RESOLUTION / fP_MAX)
+
+struct Attractor {
+	float x, y, strength;
+
+	Attractor() {}
+	Attractor(const float x, const float y, const float strength) : x(x), y(y), strength(strength) {}
+};
+
+class Field {
+public:
+	// combined force per cell, sampled by the kernel
+	float force_x[FIELD_CELLS];
+	float force_y[FIELD_CELLS];
+
+	// nonzero for cells covered by an obstacle
+	uint8_t obstacle_mask[FIELD_CELLS];
+
+	std::vector<Attractor> attractors;
+
+	// set whenever obstacles change, so the renderer
+	// knows to refresh its copy of the mask
+	bool mask_changed;
+
+private:
+	// obstacle repulsion layer, rebuilt (lazily) from the mask
+	float obstacle_fx[FIELD_CELLS];
+	float obstacle_fy[FIELD_CELLS];
+
+	// attractor layer, updated incrementally per attractor
+	float attractor_fx[FIELD_CELLS];
+	float attractor_fy[FIELD_CELLS];
+
+	bool obstacles_dirty;
+	bool combine_dirty;
+
+public:
+	Field();
+
+	// mark a disc of radius r (P units) centered on (x, y) as obstacle
+	void addObstacleDisc(const float x, const float y, const float r);
+
+	// mark every nonzero entry of a w x h byte mask as obstacle,
+	// stretching the mask over the whole P_MAX square
+	void addObstacleMask(const uint8_t* const mask, const int w, const int h);
+
+	void clearObstacles();
+
+	// point attractor (positive strength) or repulsor (negative strength)
+	void addAttractor(const float x, const float y, const float strength);
+
+	void clearAttractors();
+
+	// rebuild whatever has changed since the last call.
+	// Must not be called while the kernel is sampling.
+	void update();
+
+	// bilinearly sample the combined force at (x, y)
+	inline void sample(const float x, const float y, float& fx, float& fy) const {
+		// cell centers sit at (i + 0.5) * cell size
+		float u = x * fFIELD_INV_CELL_SIZE - 0.5f;
+		float v = y * fFIELD_INV_CELL_SIZE - 0.5f;
+		float fu = floorf(u);
+		float fv = floorf(v);
+		float tu = u - fu;
+		float tv = v - fv;
+		int i0 = static_cast<int>(fu);
+		int j0 = static_cast<int>(fv);
+		int i1 = i0 + 1;
+		int j1 = j0 + 1;
+
+#ifdef SCREEN_WRAP
+		// FIELD_RESOLUTION is a power of 2, so masking wraps negatives too
+		i0 &= FIELD_RESOLUTION - 1; i1 &= FIELD_RESOLUTION - 1;
+		j0 &= FIELD_RESOLUTION - 1; j1 &= FIELD_RESOLUTION - 1;
+#else
+		i0 = std::min(std::max(i0, 0), FIELD_RESOLUTION - 1); i1 = std::min(std::max(i1, 0), FIELD_RESOLUTION - 1);
+		j0 = std::min(std::max(j0, 0), FIELD_RESOLUTION - 1); j1 = std::min(std::max(j1, 0), FIELD_RESOLUTION - 1);
+#endif
+
+		int c00 = j0 * FIELD_RESOLUTION + i0, c10 = j0 * FIELD_RESOLUTION + i1;
+		int c01 = j1 * FIELD_RESOLUTION + i0, c11 = j1 * FIELD_RESOLUTION + i1;
+
+		float top_x = force_x[c00] + tu * (force_x[c10] - force_x[c00]);
+		float bot_x = force_x[c01] + tu * (force_x[c11] - force_x[c01]);
+		float top_y = force_y[c00] + tu * (force_y[c10] - force_y[c00]);
+		float bot_y = force_y[c01] + tu * (force_y[c11] - force_y[c01]);
+
+		fx = top_x + tv * (bot_x - top_x);
+		fy = top_y + tv * (bot_y - top_y);
+	}
+
+private:
+	// NO copy construction or copy assignment. Too big to copy by accident.
+	Field(const Field&) = delete;
+	Field& operator=(const Field&) = delete;
+
+	void rebuildObstacles();
+
+	// add one attractor's contribution to the attractor layer
+	void accumulateAttractor(const Attractor& a);
+};
+
+#endif
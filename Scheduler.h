@@ -0,0 +1,125 @@
+/*******************************************************************
+*   Scheduler.h
+*   Boids
+*	agent
+*
+*	10/19/2026
+*******************************************************************/
+
+// This module contains the thread scheduler shared by everything that
+// steps boids in parallel (Physics, Physics3D, Ensemble), so the
+// chunking policy lives in one place. Each step, every thread starts
+// with 1/first_chunk_divisor of its naive share of the work, then
+// grabs 1/guided_divisor of its share of what's left each time it runs
+// out, in smaller and smaller chunks, so all threads finish the last
+// few boids at about the same time.
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <xmmintrin.h>
+
+#include "params.h"
+
+class Scheduler {
+public:
+	int num_CPU;
+
+	// scheduling granularity, see above
+	int first_chunk_divisor = 2;
+	int guided_divisor = 2;
+
+	// requested == 0 autodetects the thread count
+	void initThreads(const int requested = 0) {
+		if (requested > 0) {
+			num_CPU = std::min(requested, BOID_CAPACITY);
+		}
+		else {
+#ifdef OVERRIDE_CPU_COUNT_AUTODETECT
+			num_CPU = OVERRIDE_CPU_COUNT_AUTODETECT;
+#else
+			num_CPU = std::min(static_cast<unsigned int>(BOID_CAPACITY), std::max(std::thread::hardware_concurrency(), 1u));
+#endif
+		}
+
+		delete[] threads;
+		threads = new std::thread[num_CPU];
+	}
+
+protected:
+	Scheduler() : num_CPU(1), threads(nullptr), cur_idx(0) {}
+
+	~Scheduler() { delete[] threads; }
+
+	// call process(start_idx, end_idx) on num_CPU threads until
+	// every index in [0, n) has been handed out exactly once,
+	// and return when all are done. Needs initThreads first.
+	template <typename F>
+	void schedule(const int n, F process);
+
+	// also free for other parallel passes between schedules
+	std::thread* threads;
+
+private:
+	// NO copy construction or copy assignment.
+	Scheduler(const Scheduler&) = delete;
+	Scheduler& operator=(const Scheduler&) = delete;
+
+	template <typename F>
+	void launchThread(int start_idx, int end_idx, const int n, F& process);
+
+	// next index to hand out
+	int cur_idx;
+
+	// for blocking cur_idx
+	std::mutex mtx;
+};
+
+template <typename F>
+void Scheduler::schedule(const int n, F process) {
+	int start_idx;
+
+	// send out threads, each with its first chunk. The rest
+	// is handed out by launchThread, mutexed by mtx.
+	mtx.lock();
+	for (int i = 0; i < num_CPU; ++i) {
+		start_idx = cur_idx;
+		cur_idx += n / num_CPU / first_chunk_divisor + 1;
+		threads[i] = std::thread(&Scheduler::launchThread<F>, this, start_idx, std::min(cur_idx, n) - 1, n, std::ref(process));
+	}
+	mtx.unlock();
+
+	// wait for all threads to return
+	for (int i = 0; i < num_CPU; ++i) {
+		threads[i].join();
+	}
+
+	// reset for next step
+	cur_idx = 0;
+}
+
+template <typename F>
+void Scheduler::launchThread(int start_idx, int end_idx, const int n, F& process) {
+	_MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+
+	for (;;) {
+		process(start_idx, end_idx);
+
+		// dynamic thread reassign
+		mtx.lock();
+		if (cur_idx >= n) {
+			mtx.unlock();
+			return;
+		}
+		start_idx = cur_idx;
+		cur_idx += (n - cur_idx) / num_CPU / guided_divisor + 1;
+		end_idx = std::min(cur_idx, n) - 1;
+		mtx.unlock();
+	}
+}
+
+#endif
@@ -0,0 +1,126 @@
+/*******************************************************************
+*   Species.cpp
+*   Boids
+*	agent
+*
+*	10/19/2026
+*******************************************************************/
+
+// This module contains the species table. See Species.h.
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "Species.h"
+
+static const SpeciesPair DEFAULT_PAIR = { 1.0f, 1.0f, 1.0f, 1.0f, 0.0f };
+
+SpeciesTable::SpeciesTable() : num_species(1) {
+	// every slot fully set, so copying a table never reads garbage
+	for (int i = 0; i < MAX_SPECIES; ++i) {
+		species[i].count = 0;
+		species[i].speed = 1.0f;
+		species[i].fixed_color = false;
+		species[i].R = species[i].G = species[i].B = 0;
+	}
+
+	species[0].name = "boid";
+	species[0].count = NUMBER_OF_BOIDS;
+
+	for (int a = 0; a < MAX_SPECIES; ++a) {
+		for (int b = 0; b < MAX_SPECIES; ++b) pairs[a][b] = DEFAULT_PAIR;
+	}
+}
+
+int SpeciesTable::find(const std::string& name) const {
+	for (int i = 0; i < num_species; ++i) {
+		if (species[i].name == name) return i;
+	}
+	return -1;
+}
+
+int SpeciesTable::totalCount() const {
+	int total = 0;
+	for (int i = 0; i < num_species; ++i) total += species[i].count;
+	return total;
+}
+
+bool SpeciesTable::load(const std::string& path) {
+	std::ifstream f(path);
+	if (!f) return true;
+
+	// build into a fresh table so a bad file changes nothing
+	SpeciesTable table;
+	table.num_species = 0;
+
+	std::string line, kind;
+	for (int line_num = 1; std::getline(f, line); ++line_num) {
+		std::istringstream ss(line.substr(0, line.find('#')));
+		if (!(ss >> kind)) continue;
+
+		if (kind == "species") {
+			if (table.num_species == MAX_SPECIES) {
+				std::cerr << "ERROR: " << path << ':' << line_num << ": more than MAX_SPECIES (" << MAX_SPECIES << ") species." << std::endl;
+				return false;
+			}
+
+			Species& s = table.species[table.num_species];
+			if (!(ss >> s.name >> s.count >> s.speed) || s.count < 0 || s.speed <= 0.0f || table.find(s.name) >= 0) {
+				std::cerr << "ERROR: " << path << ':' << line_num << ": expected species <name> <count> <speed> [<R> <G> <B>] with a new name." << std::endl;
+				return false;
+			}
+
+			int R, G, B;
+			s.fixed_color = static_cast<bool>(ss >> R >> G >> B);
+			s.R = static_cast<uint8_t>(R);
+			s.G = static_cast<uint8_t>(G);
+			s.B = static_cast<uint8_t>(B);
+
+			++table.num_species;
+		}
+		else if (kind == "pair") {
+			std::string a, b;
+			SpeciesPair pair = DEFAULT_PAIR;
+			if (!(ss >> a >> b >> pair.range >> pair.cohesion >> pair.alignment >> pair.repulsion) || pair.range < 0.0f) {
+				std::cerr << "ERROR: " << path << ':' << line_num << ": expected pair <a> <b> <range> <cohesion> <alignment> <repulsion> [<eat_range>]." << std::endl;
+				return false;
+			}
+			ss >> pair.eat_range;
+			if (pair.eat_range < 0.0f) pair.eat_range = 0.0f;
+
+			const int ia = table.find(a), ib = table.find(b);
+			if (ia < 0 || ib < 0) {
+				std::cerr << "ERROR: " << path << ':' << line_num << ": unknown species " << (ia < 0 ? a : b) << " (declare species before pairs)." << std::endl;
+				return false;
+			}
+
+			// a species eating itself would eat each boid (its own neighbor)
+			if (ia == ib && pair.eat_range > 0.0f) {
+				std::cerr << "ERROR: " << path << ':' << line_num << ": species " << a << " can't eat itself." << std::endl;
+				return false;
+			}
+
+			// each boid must count itself as a neighbor, or one with
+			// nothing else in range averages over 0 neighbors
+			if (ia == ib && pair.range <= 0.0f) {
+				std::cerr << "ERROR: " << path << ':' << line_num << ": species " << a << " needs a range above 0 with itself." << std::endl;
+				return false;
+			}
+
+			table.pairs[ia][ib] = pair;
+		}
+		else {
+			std::cerr << "ERROR: " << path << ':' << line_num << ": unknown entry " << kind << '.' << std::endl;
+			return false;
+		}
+	}
+
+	if (!table.num_species || !table.totalCount()) {
+		std::cerr << "ERROR: " << path << " has no boids." << std::endl;
+		return false;
+	}
+
+	*this = table;
+	return true;
+}
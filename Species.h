@@ -0,0 +1,86 @@
+/*******************************************************************
+*   Species.h
+*   Boids
+*	agent
+*
+*	10/19/2026
+*******************************************************************/
+
+// This module contains the species table: per-species and
+// per-species-pair parameters, loaded at startup from SPECIES_FILE.
+// Every value is a multiplier on the params.h/SimParams setting it
+// modifies, so the default table (one species, all 1s) is exactly
+// the classic single-flock simulation, and runtime SimParams (e.g.
+// ensemble sweeps) still scale every species.
+//
+// Boids are kept sorted by species, so the kernel walks one
+// species range at a time with that pair's constants hoisted
+// out of the loop instead of looking them up per neighbor.
+//
+// File format, one entry per line, # comments:
+//	species <name> <count> <speed> [<R> <G> <B>]
+//	pair <a> <b> <range> <cohesion> <alignment> <repulsion> [<eat_range>]
+//
+// count is the species' share of the initial population and speed
+// scales V_LIM. An RGB color overrides direction-of-travel coloring.
+// A pair line says how species a reacts to b: range scales
+// NEIGHBOR_DISTANCE, the next three scale the center of mass,
+// alignment and repulsion strengths (negative cohesion flees), and
+// with eat_range > 0, boids of b within eat_range * NEIGHBOR_DISTANCE
+// of a boid of a are eaten, i.e. despawned. Unlisted pairs are all 1s
+// with no eating.
+
+#ifndef SPECIES_H
+#define SPECIES_H
+
+#include <cstdint>
+#include <string>
+
+#include "params.h"
+
+struct Species {
+	std::string name;
+
+	// share of the initial population
+	int count;
+
+	// multiplier on v_lim
+	float speed;
+
+	bool fixed_color;
+	uint8_t R, G, B;
+};
+
+// how a boid of one species reacts to neighbors of another
+struct SpeciesPair {
+	// multipliers on NEIGHBOR_DISTANCE and the SimParams strengths
+	float range, cohesion, alignment, repulsion;
+
+	// multiplier on NEIGHBOR_DISTANCE, 0 to never eat
+	float eat_range;
+};
+
+class SpeciesTable {
+public:
+	// the default: one species, everyone
+	SpeciesTable();
+
+	// replace the table with the one in path. A missing file keeps
+	// the current table and is not an error; a malformed one is.
+	bool load(const std::string& path);
+
+	// index of the species called name, or -1
+	int find(const std::string& name) const;
+
+	// sum of all species' counts
+	int totalCount() const;
+
+	int num_species;
+
+	Species species[MAX_SPECIES];
+
+	// pairs[a][b]: how a reacts to b
+	SpeciesPair pairs[MAX_SPECIES][MAX_SPECIES];
+};
+
+#endif
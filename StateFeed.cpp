@@ -0,0 +1,112 @@
+/*******************************************************************
+*   StateFeed.cpp
+*   Boids
+*	agent
+*
+*	10/19/2026
+*******************************************************************/
+
+// This module contains the optional live state feed. See StateFeed.h.
+
+#include "StateFeed.h"
+
+#ifdef STATE_FEED
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static_assert(sizeof(FeedHeader) % STATE_FEED_ALIGN == 0, "state feed slots must start on a cache line");
+
+bool StateFeed::open(const std::string& shm_name, const int num_slots, const int slot_capacity) {
+	close();
+
+	const uint64_t stride = (sizeof(FeedSlot) + slot_capacity * sizeof(FeedBoid) + STATE_FEED_ALIGN - 1) / STATE_FEED_ALIGN * STATE_FEED_ALIGN;
+	const size_t bytes = sizeof(FeedHeader) + num_slots * stride;
+
+	// start from a fresh object so stale readers of a previous
+	// run keep their old mapping rather than seeing this one change size
+	shm_unlink(shm_name.c_str());
+	int fd = shm_open(shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+	if (fd < 0) {
+		std::cerr << "ERROR: unable to create shared memory " << shm_name << ": " << strerror(errno) << '.' << std::endl;
+		return false;
+	}
+
+	if (ftruncate(fd, bytes)) {
+		std::cerr << "ERROR: unable to size shared memory " << shm_name << ": " << strerror(errno) << '.' << std::endl;
+		::close(fd);
+		shm_unlink(shm_name.c_str());
+		return false;
+	}
+
+	void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (p == MAP_FAILED) {
+		std::cerr << "ERROR: unable to map shared memory " << shm_name << ": " << strerror(errno) << '.' << std::endl;
+		shm_unlink(shm_name.c_str());
+		return false;
+	}
+
+	name = shm_name;
+	size = bytes;
+	generation = 0;
+
+	// fresh shared memory is zeroed, which is a valid state
+	// for everything but the magic/geometry, filled in last
+	header = static_cast<FeedHeader*>(p);
+	header->num_slots = num_slots;
+	header->slot_capacity = slot_capacity;
+	header->slot_stride = stride;
+	header->version = STATE_FEED_VERSION;
+	new (&header->latest) std::atomic<uint64_t>(0);
+	for (int i = 0; i < num_slots; ++i) new (&feedSlot(header, i)->seq) std::atomic<uint64_t>(0);
+	std::atomic_thread_fence(std::memory_order_release);
+	header->magic = STATE_FEED_MAGIC;
+
+	return true;
+}
+
+void StateFeed::close() {
+	if (!header) return;
+
+	munmap(header, size);
+	shm_unlink(name.c_str());
+	header = nullptr;
+}
+
+void StateFeed::publish(const Physics& physics) {
+	if (!header) return;
+
+	FeedSlot* slot = feedSlot(header, ++generation);
+	const uint64_t seq = slot->seq.load(std::memory_order_relaxed);
+
+	// odd: readers of this slot will see it's in flux
+	slot->seq.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	const int n = std::min(physics.num_boids, static_cast<int>(header->slot_capacity));
+	slot->generation = generation;
+	slot->step_count = physics.step_count;
+	slot->sim_time = physics.sim_time;
+	slot->num_boids = n;
+
+	FeedBoid* out = slot->boids();
+	for (int i = 0; i < n; ++i) {
+		out[i].x = physics.in[i].x;
+		out[i].y = physics.in[i].y;
+		out[i].vx = physics.in[i].vx;
+		out[i].vy = physics.in[i].vy;
+	}
+
+	// even again: slot is consistent
+	slot->seq.store(seq + 2, std::memory_order_release);
+	header->latest.store(generation, std::memory_order_release);
+}
+
+#endif
@@ -0,0 +1,120 @@
+/*******************************************************************
+*   StateFeed.h
+*   Boids
+*	agent
+*
+*	10/19/2026
+*******************************************************************/
+
+// This module contains the optional live state feed. Each completed
+// step is published into a POSIX shared-memory ring of STATE_FEED_SLOTS
+// slots so other processes (analytics, secondary visualizers) can map
+// it and read boid state in place. Every slot is guarded by a seqlock:
+// the publisher never waits on readers and readers never take a lock,
+// they just retry if the slot changed underneath them.
+//
+// Shared memory layout:
+//	FeedHeader
+//	num_slots x { FeedSlot, slot_capacity FeedBoids }, slot_stride bytes apart
+//
+// Reading the latest state:
+//	1. g = header->latest (acquire); 0 means nothing published yet
+//	2. slot = g % num_slots; s1 = slot->seq (acquire); retry if s1 is odd
+//	3. use the slot's boids in place
+//	4. acquire fence; if slot->seq != s1 or slot->generation != g,
+//	   the slot was overwritten meanwhile - discard and retry
+//
+// feed_reader.cpp is a small reference reader.
+
+#ifndef STATE_FEED_H
+#define STATE_FEED_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "params.h"
+
+// "BFED" in a little-endian mapping
+#define STATE_FEED_MAGIC			(0x44454642u)
+#define STATE_FEED_VERSION			(2u)
+
+// the header and every slot start on their own cache lines
+// so readers of one slot don't contend with writes to the next
+#define STATE_FEED_ALIGN			(64)
+
+// the atomics live in memory shared between processes,
+// which is only sound if they're lock-free
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "state feed needs lock-free 64-bit atomics");
+
+struct FeedBoid {
+	float x, y, vx, vy;
+};
+
+// padded to STATE_FEED_ALIGN so slot 0, right after it, is aligned
+struct alignas(STATE_FEED_ALIGN) FeedHeader {
+	uint32_t magic, version;
+	uint32_t num_slots, slot_capacity;
+	uint64_t slot_stride;
+
+	// generation of the most recently completed slot, 0 if none
+	std::atomic<uint64_t> latest;
+};
+
+struct FeedSlot {
+	// odd while the publisher is writing this slot
+	std::atomic<uint64_t> seq;
+
+	uint64_t generation, step_count;
+	double sim_time;
+	uint32_t num_boids, reserved;
+
+	const FeedBoid* boids() const { return reinterpret_cast<const FeedBoid*>(this + 1); }
+	FeedBoid* boids() { return reinterpret_cast<FeedBoid*>(this + 1); }
+};
+
+inline FeedSlot* feedSlot(FeedHeader* const header, const uint64_t generation) {
+	return reinterpret_cast<FeedSlot*>(reinterpret_cast<char*>(header + 1) + (generation % header->num_slots) * header->slot_stride);
+}
+
+inline const FeedSlot* feedSlot(const FeedHeader* const header, const uint64_t generation) {
+	return reinterpret_cast<const FeedSlot*>(reinterpret_cast<const char*>(header + 1) + (generation % header->num_slots) * header->slot_stride);
+}
+
+#ifdef STATE_FEED
+
+#ifdef _WIN32
+#error "STATE_FEED needs POSIX shared memory"
+#endif
+
+#include "Boids.h"
+
+class StateFeed {
+public:
+	StateFeed() : header(nullptr), size(0), generation(0) {}
+
+	~StateFeed() { close(); }
+
+	// create (or replace) the shared-memory object
+	bool open(const std::string& shm_name, const int num_slots, const int slot_capacity);
+
+	void close();
+
+	// publish physics.in, i.e. call right after the ping-pong swap
+	void publish(const Physics& physics);
+
+private:
+	// NO copy construction or copy assignment.
+	StateFeed(const StateFeed&) = delete;
+	StateFeed& operator=(const StateFeed&) = delete;
+
+	FeedHeader* header;
+	size_t size;
+	uint64_t generation;
+	std::string name;
+};
+
+#endif
+
+#endif
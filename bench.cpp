@@ -0,0 +1,317 @@
+/*******************************************************************
+*   bench.cpp
+*   Boids
+*	agent
+*
+*	10/19/2026
+*******************************************************************/
+
+// Standalone microbenchmarks for the hot paths in Boids.cpp:
+// the screenwrap distance helpers, angleToRGB, a single boid's
+// neighbor accumulation and a full processRules step at several
+// populations and thread counts, with and without flock
+// analytics, and the 3D grid step (see Boids3D.h) at the same
+// populations and thread counts. Does not need SDL, e.g.:
+//
+//	g++ -std=c++14 -O3 -pthread Analytics.cpp bench.cpp Boids.cpp Boids3D.cpp Checkpoint.cpp Field.cpp Species.cpp -o bench
+//
+// Usage:
+//	bench [--quick] [--save <file>] [--compare <file>] [--threshold <percent>] [--checkpoint <file>]
+//
+//	--quick			-	fewer repetitions, for a fast sanity check
+//	--save			-	write results as a baseline file
+//	--compare		-	compare against a baseline file; exits with
+//						failure if anything regressed past the threshold
+//	--threshold		-	allowed slowdown vs. baseline (default 10%)
+//	--checkpoint	-	run the neighbor and step benchmarks on a saved flock
+//						(see Checkpoint.h) instead of fresh spawns
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Boids.h"
+#include "Boids3D.h"
+#include "Checkpoint.h"
+
+#define BENCH_WARMUP_REPS			(3)
+#define BENCH_REPS					(15)
+#define BENCH_QUICK_REPS			(5)
+#define BENCH_MICRO_OPS				(1 << 20)
+#define BENCH_MICRO_INPUTS			(4096)
+#define BENCH_NEIGHBOR_OPS			(256)
+#define BENCH_STEP_WARMUP			(20)
+#define BENCH_DEFAULT_THRESHOLD		(10.0)
+#define BENCH_FRAME_MS				(16.0f)
+#define BENCH_SCREEN_WIDTH			(1920.0f)
+#define BENCH_SCREEN_HEIGHT			(1080.0f)
+
+struct BenchResult {
+	std::string name;
+	double ns_mean, ns_stddev, pairs_per_sec;
+};
+
+// results land here so the optimizer can't discard the benchmarked work
+volatile float sink;
+
+// time f(ops) for BENCH_WARMUP_REPS discarded and then reps kept
+// repetitions, reporting mean and standard deviation of ns per op
+template <typename F>
+static BenchResult runBench(const std::string& name, const int ops, const double pairs_per_op, const int reps, F f) {
+	std::vector<double> samples;
+
+	for (int r = 0; r < BENCH_WARMUP_REPS + reps; ++r) {
+		std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+		f(ops);
+		std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+		if (r >= BENCH_WARMUP_REPS) samples.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count() / ops);
+	}
+
+	double mean = 0.0, var = 0.0;
+	for (double s : samples) mean += s;
+	mean /= samples.size();
+	for (double s : samples) var += (s - mean) * (s - mean);
+	var /= std::max(static_cast<int>(samples.size()) - 1, 1);
+
+	BenchResult res = { name, mean, sqrt(var), pairs_per_op > 0.0 ? pairs_per_op * 1e9 / mean : 0.0 };
+
+	printf("%-32s %14.2f ns/op  +- %5.1f%%", name.c_str(), res.ns_mean, 100.0 * res.ns_stddev / res.ns_mean);
+	if (res.pairs_per_sec > 0.0) printf("  %10.3e pairs/s", res.pairs_per_sec);
+	printf("\n");
+
+	return res;
+}
+
+// advance the simulation one frame, ending it with swapBuffers as main
+// does so any despawns (e.g. eaten boids) are applied and cleared
+static void step(Physics& physics) {
+	physics.processRules();
+	physics.swapBuffers();
+}
+
+static bool saveBaseline(const std::string& path, const std::vector<BenchResult>& results) {
+	std::ofstream f(path);
+	if (!f) {
+		fprintf(stderr, "ERROR: unable to write baseline %s.\n", path.c_str());
+		return false;
+	}
+
+	f << "# Boids bench baseline: name ns_per_op stddev_ns\n";
+	for (const BenchResult& r : results) f << r.name << ' ' << r.ns_mean << ' ' << r.ns_stddev << '\n';
+
+	return true;
+}
+
+// returns number of regressions, or -1 if the baseline can't be read
+static int compareBaseline(const std::string& path, const std::vector<BenchResult>& results, const double threshold) {
+	std::ifstream f(path);
+	if (!f) {
+		fprintf(stderr, "ERROR: unable to read baseline %s.\n", path.c_str());
+		return -1;
+	}
+
+	std::map<std::string, double> base;
+	std::string line;
+	double ns, sd;
+	while (std::getline(f, line)) {
+		if (line.empty() || line[0] == '#') continue;
+		if (sscanf(line.c_str(), "%*s %lf %lf", &ns, &sd) == 2) base[line.substr(0, line.find(' '))] = ns;
+	}
+
+	int regressions = 0;
+	printf("\n%-32s %14s %14s %9s\n", "vs. baseline", "baseline", "now", "change");
+	for (const BenchResult& r : results) {
+		std::map<std::string, double>::const_iterator it = base.find(r.name);
+		if (it == base.end()) {
+			printf("%-32s %14s %14.2f %9s\n", r.name.c_str(), "-", r.ns_mean, "new");
+			continue;
+		}
+
+		double change = 100.0 * (r.ns_mean - it->second) / it->second;
+		bool regressed = change > threshold;
+		regressions += regressed;
+		printf("%-32s %14.2f %14.2f %+8.1f%%%s\n", r.name.c_str(), it->second, r.ns_mean, change, regressed ? "  REGRESSION" : "");
+	}
+
+	return regressions;
+}
+
+int main(int argc, char* argv[]) {
+	_MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+
+	int reps = BENCH_REPS;
+	double threshold = BENCH_DEFAULT_THRESHOLD;
+	std::string save_path, compare_path, checkpoint_path;
+
+	for (int i = 1; i < argc; ++i) {
+		if (!strcmp(argv[i], "--quick")) reps = BENCH_QUICK_REPS;
+		else if (!strcmp(argv[i], "--save") && i + 1 < argc) save_path = argv[++i];
+		else if (!strcmp(argv[i], "--compare") && i + 1 < argc) compare_path = argv[++i];
+		else if (!strcmp(argv[i], "--threshold") && i + 1 < argc) threshold = atof(argv[++i]);
+		else if (!strcmp(argv[i], "--checkpoint") && i + 1 < argc) checkpoint_path = argv[++i];
+		else {
+			fprintf(stderr, "Usage: %s [--quick] [--save <file>] [--compare <file>] [--threshold <percent>] [--checkpoint <file>]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::vector<BenchResult> results;
+
+	// fixed inputs for the scalar helpers
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<float> pos(0.0f, fP_MAX);
+	std::uniform_real_distribution<float> angle(0.0f, 2.0f * fPI);
+	std::vector<float> a(BENCH_MICRO_INPUTS), b(BENCH_MICRO_INPUTS), angles(BENCH_MICRO_INPUTS);
+	for (int i = 0; i < BENCH_MICRO_INPUTS; ++i) {
+		a[i] = pos(rng);
+		b[i] = pos(rng);
+		angles[i] = angle(rng);
+	}
+
+#ifdef SCREEN_WRAP
+	results.push_back(runBench("fastdiff", BENCH_MICRO_OPS, 0.0, reps, [&](const int ops) {
+		float acc = 0.0f;
+		for (int i = 0; i < ops; ++i) acc += fastdiff(a[i & (BENCH_MICRO_INPUTS - 1)], b[i & (BENCH_MICRO_INPUTS - 1)]);
+		sink = acc;
+	}));
+
+	results.push_back(runBench("diff", BENCH_MICRO_OPS, 0.0, reps, [&](const int ops) {
+		float acc = 0.0f;
+		for (int i = 0; i < ops; ++i) acc += diff(a[i & (BENCH_MICRO_INPUTS - 1)], b[i & (BENCH_MICRO_INPUTS - 1)]);
+		sink = acc;
+	}));
+
+	results.push_back(runBench("fastdiffToDiff", BENCH_MICRO_OPS, 0.0, reps, [&](const int ops) {
+		float acc = 0.0f, c1, c2;
+		for (int i = 0; i < ops; ++i) {
+			c1 = a[i & (BENCH_MICRO_INPUTS - 1)];
+			c2 = b[i & (BENCH_MICRO_INPUTS - 1)];
+			acc += fastdiffToDiff(fastdiff(c1, c2), c1, c2);
+		}
+		sink = acc;
+	}));
+#endif
+
+#ifdef DYNAMIC_COLOR_MODE
+	results.push_back(runBench("angleToRGB", BENCH_MICRO_OPS, 0.0, reps, [&](const int ops) {
+		int acc = 0;
+		RGB c;
+		for (int i = 0; i < ops; ++i) {
+			c = angleToRGB(angles[i & (BENCH_MICRO_INPUTS - 1)]);
+			acc += c.R + c.G + c.B;
+		}
+		sink = static_cast<float>(acc);
+	}));
+#endif
+
+	Physics& physics = Physics::getInstance();
+	physics.fWidth = BENCH_SCREEN_WIDTH;
+	physics.fHeight = BENCH_SCREEN_HEIGHT;
+	physics.time_since_last_frame = BENCH_FRAME_MS;
+
+	// populations to sweep, capped at the compiled-in capacity,
+	// or just the checkpoint's population if starting from one
+	std::vector<int> populations;
+	if (!checkpoint_path.empty()) {
+		if (!Checkpointer::restore(physics, checkpoint_path)) return EXIT_FAILURE;
+		populations.push_back(physics.num_boids);
+	}
+	else {
+		for (int n : { 500, 1000, 2000 }) if (n < NUMBER_OF_BOIDS) populations.push_back(n);
+		populations.push_back(NUMBER_OF_BOIDS);
+	}
+
+	// thread counts to sweep: powers of 2 up to, plus, the core count
+	int hw = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+	std::vector<int> thread_counts;
+	for (int t = 1; t < hw; t *= 2) thread_counts.push_back(t);
+	thread_counts.push_back(hw);
+
+	for (int n : populations) {
+		physics.num_boids = n;
+		physics.initThreads();
+
+		// let the flock form a bit so neighbor counts are representative
+		// (a checkpoint is already representative)
+		if (checkpoint_path.empty()) {
+			// same flock every run, so --compare times like with like
+			physics.seedRNG(1);
+			physics.spawnBoids();
+			for (int i = 0; i < BENCH_STEP_WARMUP; ++i) step(physics);
+		}
+
+		results.push_back(runBench("neighbors/N=" + std::to_string(n), BENCH_NEIGHBOR_OPS, n, reps, [&](const int ops) {
+			NeighborSums sums;
+			float acc = 0.0f;
+			for (int i = 0; i < ops; ++i) {
+				physics.accumulateNeighbors(physics.in[i % n].species, physics.in[i % n].x, physics.in[i % n].y, physics.in[i % n].vx, physics.in[i % n].vy, sums);
+				acc += sums.CMsumX + sums.neighbors;
+			}
+			sink = acc;
+		}));
+
+		for (int t : thread_counts) {
+			physics.initThreads(t);
+#ifdef FLOCK_ANALYTICS
+			physics.analytics_enabled = false;
+#endif
+			results.push_back(runBench("step/N=" + std::to_string(n) + "/T=" + std::to_string(t), 1, static_cast<double>(n) * n, reps, [&](const int ops) {
+				for (int i = 0; i < ops; ++i) step(physics);
+			}));
+
+#ifdef FLOCK_ANALYTICS
+			// same step with flock analytics, to keep its overhead honest
+			physics.analytics_enabled = true;
+			results.push_back(runBench("step+flock/N=" + std::to_string(n) + "/T=" + std::to_string(t), 1, static_cast<double>(n) * n, reps, [&](const int ops) {
+				for (int i = 0; i < ops; ++i) step(physics);
+			}));
+#endif
+		}
+	}
+
+	// the 3D grid step. Pairs tested depend on the flock's shape,
+	// not N^2, so only time per step is reported.
+	Physics3D& physics3d = Physics3D::getInstance();
+	physics3d.fWidth = BENCH_SCREEN_WIDTH;
+	physics3d.fHeight = BENCH_SCREEN_HEIGHT;
+	physics3d.time_since_last_frame = BENCH_FRAME_MS;
+
+	for (int n : populations) {
+		physics3d.num_boids = n;
+		physics3d.initThreads();
+		physics3d.seedRNG(1);
+		physics3d.spawnBoids();
+		for (int i = 0; i < BENCH_STEP_WARMUP; ++i) {
+			physics3d.processRules();
+			physics3d.swapBuffers();
+		}
+
+		for (int t : thread_counts) {
+			physics3d.initThreads(t);
+			results.push_back(runBench("step3d/N=" + std::to_string(n) + "/T=" + std::to_string(t), 1, 0.0, reps, [&](const int ops) {
+				for (int i = 0; i < ops; ++i) {
+					physics3d.processRules();
+					physics3d.swapBuffers();
+				}
+			}));
+		}
+	}
+
+	if (!save_path.empty() && !saveBaseline(save_path, results)) return EXIT_FAILURE;
+
+	if (!compare_path.empty()) {
+		int regressions = compareBaseline(compare_path, results, threshold);
+		if (regressions) {
+			if (regressions > 0) printf("\n%d regression(s) beyond %.1f%%.\n", regressions, threshold);
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
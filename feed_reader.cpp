@@ -0,0 +1,155 @@
+/*******************************************************************
+*   feed_reader.cpp
+*   Boids
+*	agent
+*
+*	10/19/2026
+*******************************************************************/
+
+// Reference reader for the shared-memory state feed (see StateFeed.h).
+// Maps the feed read-only and, for each new generation, computes a few
+// stats directly on the shared slot - no copy - then validates the
+// slot's seqlock and throws the result away if it was torn. Prints
+// one line per interval, plus how many generations were missed and
+// how many reads had to be retried. Build on POSIX, e.g.:
+//
+//	g++ -std=c++14 -O2 feed_reader.cpp -o feed_reader -lrt
+//
+// Usage:
+//	feed_reader [--name <shm name>] [--interval <ms>] [--count <n>]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "StateFeed.h"
+
+#define READER_DEFAULT_INTERVAL_MS	(500)
+#define READER_RETRY_LIMIT			(100)
+
+struct FeedStats {
+	uint64_t generation, step_count;
+	double sim_time;
+	uint32_t num_boids;
+	float mean_x, mean_y, mean_speed;
+};
+
+// read the latest slot in place. Returns false if nothing has been
+// published yet or every attempt was torn by the publisher.
+static bool readLatest(const FeedHeader* const header, FeedStats& stats, int& retries) {
+	for (int attempt = 0; attempt < READER_RETRY_LIMIT; ++attempt) {
+		const uint64_t g = header->latest.load(std::memory_order_acquire);
+		if (!g) return false;
+
+		const FeedSlot* slot = feedSlot(header, g);
+		const uint64_t s1 = slot->seq.load(std::memory_order_acquire);
+		if (s1 & 1) {
+			++retries;
+			continue;
+		}
+
+		// work on the shared data directly
+		stats.generation = slot->generation;
+		stats.step_count = slot->step_count;
+		stats.sim_time = slot->sim_time;
+		stats.num_boids = std::min(slot->num_boids, header->slot_capacity);
+
+		const FeedBoid* b = slot->boids();
+		double sx = 0.0, sy = 0.0, sv = 0.0;
+		for (uint32_t i = 0; i < stats.num_boids; ++i) {
+			sx += b[i].x;
+			sy += b[i].y;
+			sv += sqrt(b[i].vx * b[i].vx + b[i].vy * b[i].vy);
+		}
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot->seq.load(std::memory_order_relaxed) != s1 || stats.generation != g) {
+			++retries;
+			continue;
+		}
+
+		const double n = stats.num_boids ? stats.num_boids : 1;
+		stats.mean_x = static_cast<float>(sx / n);
+		stats.mean_y = static_cast<float>(sy / n);
+		stats.mean_speed = static_cast<float>(sv / n);
+		return true;
+	}
+
+	return false;
+}
+
+int main(int argc, char* argv[]) {
+	std::string name = STATE_FEED_NAME;
+	int interval_ms = READER_DEFAULT_INTERVAL_MS;
+	long count = -1;
+
+	for (int i = 1; i < argc; ++i) {
+		if (!strcmp(argv[i], "--name") && i + 1 < argc) name = argv[++i];
+		else if (!strcmp(argv[i], "--interval") && i + 1 < argc) interval_ms = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--count") && i + 1 < argc) count = atol(argv[++i]);
+		else {
+			fprintf(stderr, "Usage: %s [--name <shm name>] [--interval <ms>] [--count <n>]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	int fd = shm_open(name.c_str(), O_RDONLY, 0);
+	if (fd < 0) {
+		fprintf(stderr, "ERROR: no state feed at %s. Is Boids running with STATE_FEED defined?\n", name.c_str());
+		return EXIT_FAILURE;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) || static_cast<size_t>(st.st_size) < sizeof(FeedHeader)) {
+		fprintf(stderr, "ERROR: state feed %s is too small.\n", name.c_str());
+		return EXIT_FAILURE;
+	}
+
+	void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (p == MAP_FAILED) {
+		fprintf(stderr, "ERROR: unable to map state feed %s.\n", name.c_str());
+		return EXIT_FAILURE;
+	}
+
+	const FeedHeader* header = static_cast<const FeedHeader*>(p);
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (header->magic != STATE_FEED_MAGIC || header->version != STATE_FEED_VERSION ||
+		sizeof(FeedHeader) + header->num_slots * header->slot_stride > static_cast<size_t>(st.st_size)) {
+		fprintf(stderr, "ERROR: %s is not a version %u state feed.\n", name.c_str(), STATE_FEED_VERSION);
+		return EXIT_FAILURE;
+	}
+
+	printf("%s: %u slots x %u boids\n", name.c_str(), header->num_slots, header->slot_capacity);
+
+	FeedStats stats;
+	uint64_t last_generation = 0, missed = 0;
+	int retries = 0;
+
+	for (long i = 0; count < 0 || i < count; ++i) {
+		if (readLatest(header, stats, retries) && stats.generation != last_generation) {
+			if (last_generation) missed += stats.generation - last_generation - 1;
+			last_generation = stats.generation;
+
+			printf("gen %8llu  step %8llu  t %9.1f s  boids %5u  center (%7.1f, %7.1f)  mean speed %6.1f  missed %llu  retries %d\n",
+				static_cast<unsigned long long>(stats.generation), static_cast<unsigned long long>(stats.step_count), stats.sim_time / 1000.0,
+				stats.num_boids, stats.mean_x, stats.mean_y, stats.mean_speed, static_cast<unsigned long long>(missed), retries);
+			fflush(stdout);
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+	}
+
+	munmap(p, st.st_size);
+	return EXIT_SUCCESS;
+}
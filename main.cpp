@@ -13,13 +13,21 @@
 // Work in progress! Plan to add a better GUI / more intuitive
 // keys.
 
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <SDL.h>
 #include <sstream>
+#include <vector>
 
+#include "Autotune.h"
 #include "Boids.h"
+#include "Boids3D.h"
+#include "Checkpoint.h"
 #include "mySDL.h"
 #include "params.h"
+#include "StateFeed.h"
 
 const std::string currentDateTime() {
 	// get current date and time to second precision
@@ -37,6 +45,37 @@ const std::string currentDateTime() {
 	return out.str();
 }
 
+// pth percentile of samples
+int percentile(std::vector<int> samples, const int p) {
+	if (samples.empty()) return 0;
+	std::vector<int>::iterator it = samples.begin() + (samples.size() - 1) * p / 100;
+	std::nth_element(samples.begin(), it, samples.end());
+	return *it;
+}
+
+#ifdef LOW_LATENCY_INPUT
+// timestamp of the newest mouse event still in the queue, or 0
+Uint32 newestQueuedInput() {
+	static SDL_Event queued[LATENCY_SAMPLES];
+	Uint32 newest = 0;
+
+	const int n = SDL_PeepEvents(queued, LATENCY_SAMPLES, SDL_PEEKEVENT, SDL_MOUSEMOTION, SDL_MOUSEBUTTONUP);
+	for (int i = 0; i < n; ++i) newest = std::max(newest, queued[i].type == SDL_MOUSEMOTION ? queued[i].motion.timestamp : queued[i].button.timestamp);
+	return newest;
+}
+#endif
+
+// what an event may have changed, for the idle (paused) path
+enum {
+	DIRTY_NONE = 0,
+
+	// overlay or window: re-present
+	DIRTY_OVERLAY = 1,
+
+	// boids or field: redraw the canvas, then re-present
+	DIRTY_SCENE = 2 | DIRTY_OVERLAY
+};
+
 int main(int argc, char* argv[]) {
 	// flush denormals to zero on Intel
 	// to prevent unexpected performance drops in FPU
@@ -56,18 +95,61 @@ int main(int argc, char* argv[]) {
 	// no inheritance required) without worry of users
 	// spawning multiple instances.
 	mySDL& sdl = mySDL::getInstance();
+#ifdef MODE_3D
+	// threads through the same Scheduler as Physics, and has
+	// the same state members for everything below that isn't 2D-only
+	Physics3D& physics = Physics3D::getInstance();
+#else
 	Physics& physics = Physics::getInstance();
+#endif
 
 	// have sdl inform the physics engine of the framebuffer dimensions
 	if (!sdl.initSDL(physics.fWidth, physics.fHeight)) return EXIT_FAILURE;
 
 	physics.initThreads();
 
+#ifndef MODE_3D
+	// the species table sets the starting population
+	if (!physics.species_table.load(SPECIES_FILE)) return EXIT_FAILURE;
+	physics.num_boids = std::min(physics.species_table.totalCount(), physics.capacity);
+#endif
+
 	physics.spawnBoids();
 
+#ifdef LOW_LATENCY_INPUT
+	// the kernel leaves the mouse to applyLateMouse
+	physics.late_mouse = true;
+#endif
+
+#ifndef MODE_3D
+	// optionally warm start from a checkpoint given on the command line
+	if (argc > 1 && !Checkpointer::restore(physics, argv[1])) return EXIT_FAILURE;
+
+	// writes checkpoints in the background
+	Checkpointer checkpointer;
+#endif
+
+#ifdef STATE_FEED
+	// live state for other processes
+	StateFeed feed;
+	if (!feed.open(STATE_FEED_NAME, STATE_FEED_SLOTS, BOID_CAPACITY)) return EXIT_FAILURE;
+#endif
+
+#ifdef FIELD_MODE
+	sdl.loadObstacleBitmap(OBSTACLE_FILE, *physics.field);
+#endif
+
+#if defined(AUTOTUNE) && !defined(OVERRIDE_CPU_COUNT_AUTODETECT)
+	// time candidate schedules on the starting state
+	// (or reuse this machine's cached result)
+	const std::string threads = describeSchedule(autotune(physics, false));
+#else
+	const std::string threads = std::to_string(physics.num_CPU);
+#endif
+
 	// inform the font engine of the CPU (==thread) count, which is
 	// printed to screen
-	if (!sdl.loadFonts(physics.num_CPU)) return EXIT_FAILURE;
+	if (!sdl.loadFonts(threads)) return EXIT_FAILURE;
 
 	bool do_blank = true;
 	bool continue_running = true;
@@ -79,43 +161,195 @@ int main(int argc, char* argv[]) {
 	int fps_time = 0;
 	int fps_frames = 0;
 
-	while (continue_running) {
-		// handle events on queue
-		while (SDL_PollEvent(&e)) {
-			switch (e.type) {
-			case SDL_KEYDOWN:
-				switch (e.key.keysym.sym) {
-				case SDLK_ESCAPE:
-					continue_running = false;
-					break;
-				case SDLK_SPACE:
-					do_blank = !do_blank;
-					break;
-				case SDLK_LCTRL:
-					physics.repulsion_multiplier = -physics.repulsion_multiplier;
-					break;
-				case SDLK_LSHIFT:
-					physics.repulsion_boost = !physics.repulsion_boost;
-					break;
-				case SDLK_PRINTSCREEN:
-					sdl.saveScreenshotBMP(currentDateTime() + ".bmp");
-					break;
-				case SDLK_p:
-					physics.not_paused = !physics.not_paused;
-					break;
-				case SDLK_r:
-					physics.spawnBoids();
+	// input-to-present latency: ms from the newest mouse event
+	// reflected in a frame to that frame's present, over the
+	// last LATENCY_SAMPLES frames with new input
+	std::vector<int> latencies;
+	int latency_idx = 0;
+	Uint32 newest_input = 0;
+	Uint32 measured_input = 0;
+
+	// wall time of the last physics step, for the overlay
+	float step_ms = 0.0f;
+	std::chrono::steady_clock::time_point step_start;
+
+#ifdef FLOCK_ANALYTICS
+	// one line of flock stats per step
+	std::ofstream metrics(FLOCK_METRICS_FILE);
+	metrics << "step,sim_time_ms,boids,flocks,stragglers,largest_size,largest_x,largest_y,polarization,step_ms,finalize_ms\n";
+#endif
+
+	// re-render the overlay lines other than FPS
+	auto updateStats = [&]() {
+		sdl.text_texture1.loadFromRenderedText(sdl.font, sdl.renderer, "Boids: " + std::to_string(physics.num_boids), TEXT_COLOR);
+
+		char line[128];
+#ifdef FLOCK_ANALYTICS
+		if (physics.analytics_enabled) {
+			snprintf(line, sizeof(line), "Flocks: %d (largest %d), polarization %.2f", physics.flock_stats.flocks, physics.flock_stats.largest_size, physics.flock_stats.polarization);
+			sdl.text_texture4.loadFromRenderedText(sdl.font, sdl.renderer, line, TEXT_COLOR);
+			snprintf(line, sizeof(line), "Step: %.1f ms (analytics + %.2f ms)", step_ms, physics.flock_stats.finalize_ms);
+		}
+		else {
+			sdl.text_texture4.loadFromRenderedText(sdl.font, sdl.renderer, "Flocks: analytics off", TEXT_COLOR);
+			snprintf(line, sizeof(line), "Step: %.1f ms", step_ms);
+		}
+#else
+		snprintf(line, sizeof(line), "Step: %.1f ms", step_ms);
+#endif
+		sdl.text_texture5.loadFromRenderedText(sdl.font, sdl.renderer, line, TEXT_COLOR);
+
+		snprintf(line, sizeof(line), "Latency: %d/%d/%d ms p50/p95/p99 (%s)", percentile(latencies, 50), percentile(latencies, 95), percentile(latencies, 99), sdl.presentModeName());
+		sdl.text_texture6.loadFromRenderedText(sdl.font, sdl.renderer, line, TEXT_COLOR);
+	};
+
+	// handle one event. Returns DIRTY_* flags saying what it may have
+	// changed, which only matters while paused
+	auto handleEvent = [&](const SDL_Event& e) -> int {
+		switch (e.type) {
+		case SDL_QUIT:
+			continue_running = false;
+			return DIRTY_NONE;
+		case SDL_KEYDOWN:
+			switch (e.key.keysym.sym) {
+			case SDLK_ESCAPE:
+				continue_running = false;
+				break;
+			case SDLK_SPACE:
+				do_blank = !do_blank;
+				break;
+			case SDLK_LCTRL:
+				physics.repulsion_multiplier = -physics.repulsion_multiplier;
+				break;
+			case SDLK_LSHIFT:
+				physics.repulsion_boost = !physics.repulsion_boost;
+				break;
+			case SDLK_PRINTSCREEN:
+				sdl.saveScreenshotBMP(currentDateTime() + ".bmp");
+				break;
+			case SDLK_p:
+				physics.not_paused = !physics.not_paused;
+
+				// don't count the pause as elapsed time
+				physics.last_total_time = fps_time = SDL_GetTicks();
+				fps_frames = 0;
+				sdl.text_texture3.loadFromRenderedText(sdl.font, sdl.renderer, physics.not_paused ? "FPS: -" : "FPS: paused", TEXT_COLOR);
+				break;
+			case SDLK_r:
+				physics.spawnBoids();
+				return DIRTY_SCENE;
+#ifndef MODE_3D
+			case SDLK_EQUALS:
+				// emit a batch at the mouse, heading every which way
+				for (int i = 0; i < SPAWN_BATCH; ++i) {
+					const float angle = 2.0f * fPI * i / SPAWN_BATCH;
+					physics.spawn(physics.mouse_x * fP_MAX / physics.fWidth, physics.mouse_y * fP_MAX / physics.fHeight, V_LIM * cos(angle), V_LIM * sin(angle));
 				}
 				break;
-			case SDL_MOUSEBUTTONDOWN:
-				++physics.mouse_buttons_down;
+			case SDLK_MINUS:
+				// remove a random batch, always leaving at least one boid
+				physics.despawnRandom(SPAWN_BATCH);
+				break;
+#endif
+			case SDLK_v:
+				sdl.cyclePresentMode();
+				break;
+#ifndef MODE_3D
+			case SDLK_F5:
+				checkpointer.saveAsync(physics, CHECKPOINT_FILE);
+				break;
+			case SDLK_F9:
+				Checkpointer::restore(physics, CHECKPOINT_FILE);
+				return DIRTY_SCENE;
+#endif
+#ifdef FLOCK_ANALYTICS
+			case SDLK_g:
+				physics.analytics_enabled = !physics.analytics_enabled;
+				break;
+#endif
+#if defined(AUTOTUNE) && !defined(OVERRIDE_CPU_COUNT_AUTODETECT)
+			case SDLK_t:
+				sdl.text_texture2.loadFromRenderedText(sdl.font, sdl.renderer, "Threads: " + describeSchedule(autotune(physics, true)), TEXT_COLOR);
 				break;
-			case SDL_MOUSEBUTTONUP:
-				--physics.mouse_buttons_down;
+#endif
+#ifdef FIELD_MODE
+			case SDLK_o:
+				physics.field->addObstacleDisc(physics.mouse_x * fP_MAX / physics.fWidth, physics.mouse_y * fP_MAX / physics.fHeight, FIELD_OBSTACLE_DISC_RADIUS);
+				return DIRTY_SCENE;
+			case SDLK_a:
+				physics.field->addAttractor(physics.mouse_x * fP_MAX / physics.fWidth, physics.mouse_y * fP_MAX / physics.fHeight, physics.repulsion_multiplier * FIELD_ATTRACTOR_STRENGTH_FACTOR);
+				return DIRTY_SCENE;
+			case SDLK_c:
+				physics.field->clearObstacles();
+				physics.field->clearAttractors();
+				return DIRTY_SCENE;
+#endif
+			}
+			return DIRTY_OVERLAY;
+		case SDL_WINDOWEVENT:
+			return DIRTY_OVERLAY;
+		case SDL_MOUSEMOTION:
+			// keep the position current while idle, when there's no per-frame sample
+			physics.mouse_x = e.motion.x;
+			physics.mouse_y = e.motion.y;
+			newest_input = std::max(newest_input, e.motion.timestamp);
+			return DIRTY_NONE;
+		case SDL_MOUSEBUTTONDOWN:
+			newest_input = std::max(newest_input, e.button.timestamp);
+			++physics.mouse_buttons_down;
+			return DIRTY_NONE;
+		case SDL_MOUSEBUTTONUP:
+			newest_input = std::max(newest_input, e.button.timestamp);
+			--physics.mouse_buttons_down;
+		}
+		return DIRTY_NONE;
+	};
+
+	while (continue_running) {
+		if (!physics.not_paused) {
+			// idle: sleep until something happens, then redo only
+			// what it touched. A static scene is just re-presented
+			// from the canvas; the boids aren't redrawn.
+			int dirty = DIRTY_NONE;
+			if (SDL_WaitEventTimeout(&e, IDLE_WAIT_MS)) {
+				dirty |= handleEvent(e);
+				while (SDL_PollEvent(&e)) dirty |= handleEvent(e);
+			}
+
+			if (!physics.not_paused || !continue_running) {
+				if (dirty & DIRTY_SCENE) {
+					// no step to produce draw data for the new state
+					physics.refreshDrawData();
+					sdl.drawScene(physics, physics.in, do_blank);
+				}
+				if (dirty) {
+					updateStats();
+					sdl.present();
+				}
+				continue;
 			}
 		}
 
+		// in capped mode, wait here so input is read as late as possible
+		sdl.waitForFrameSlot();
+
+		// handle events on queue
+		while (SDL_PollEvent(&e)) handleEvent(e);
+
+#ifdef LOW_LATENCY_INPUT
+		// button state is resampled after the step too, so take
+		// it from the mouse state rather than counting events
+		physics.mouse_buttons_down = SDL_GetMouseState(&physics.mouse_x, &physics.mouse_y) != 0;
+#else
 		SDL_GetMouseState(&physics.mouse_x, &physics.mouse_y);
+#endif
+
+		// just paused: leave the last frame up and go idle
+		if (!physics.not_paused) {
+			updateStats();
+			sdl.present();
+			continue;
+		}
 
 		// compute FPS since last measured
 		total_time = SDL_GetTicks();
@@ -125,46 +359,58 @@ int main(int argc, char* argv[]) {
 			fps_time = total_time;
 			fps_frames = 0;
 			sdl.text_texture3.loadFromRenderedText(sdl.font, sdl.renderer, "FPS: " + std::to_string(framerate), TEXT_COLOR);
+			updateStats();
 		}
 		physics.time_since_last_frame = static_cast<float>(total_time - physics.last_total_time);
 		physics.last_total_time = total_time;
 
-		if (physics.not_paused) physics.processRules();
+		step_start = std::chrono::steady_clock::now();
+		physics.processRules();
+		step_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - step_start).count();
+
+#ifdef LOW_LATENCY_INPUT
+		// the mouse may have moved during the step: pick
+		// up the freshest state and apply it now
+		SDL_PumpEvents();
+		newest_input = std::max(newest_input, newestQueuedInput());
+		physics.mouse_buttons_down = SDL_GetMouseState(&physics.mouse_x, &physics.mouse_y) != 0;
+		physics.applyLateMouse();
+#endif
 
-		// clear screen
-		if (do_blank) {
-			SDL_SetRenderDrawColor(sdl.renderer, BLANKING_COLOR, SDL_ALPHA_OPAQUE);
-			SDL_RenderClear(sdl.renderer);
+#ifdef FLOCK_ANALYTICS
+		if (physics.analytics_enabled) {
+			const FlockStats& fs = physics.flock_stats;
+			metrics << physics.step_count << ',' << physics.sim_time << ',' << physics.num_boids << ',' << fs.flocks << ',' << fs.stragglers << ',' << fs.largest_size << ','
+				<< fs.largest_x << ',' << fs.largest_y << ',' << fs.polarization << ',' << step_ms << ',' << fs.finalize_ms << '\n';
 		}
+#endif
 
 		++fps_frames;
 
-		// draw lines
-#ifndef DYNAMIC_COLOR_MODE
-		SDL_SetRenderDrawColor(sdl.renderer, BOID_COLOR_IF_NOT_DYNAMIC_MODE, SDL_ALPHA_OPAQUE);
-#endif
+		sdl.drawScene(physics, physics.out, do_blank);
+		sdl.present();
 
-		for (int i = 0; i < NUMBER_OF_BOIDS; ++i) {
-#ifdef DYNAMIC_COLOR_MODE
-			SDL_SetRenderDrawColor(sdl.renderer, physics.out[i].color.R, physics.out[i].color.G, physics.out[i].color.B, SDL_ALPHA_OPAQUE);
-#endif
-			SDL_RenderDrawLine(sdl.renderer, physics.out[i].draw_x1, physics.out[i].draw_y1, physics.out[i].draw_x2, physics.out[i].draw_y2);
+		// only frames showing new input count
+		if (newest_input > measured_input) {
+			const int latency = static_cast<int>(SDL_GetTicks() - newest_input);
+			if (static_cast<int>(latencies.size()) < LATENCY_SAMPLES) latencies.push_back(latency);
+			else latencies[latency_idx] = latency;
+			latency_idx = (latency_idx + 1) % LATENCY_SAMPLES;
+			measured_input = newest_input;
 		}
 
-		// draw text
-		sdl.text_texture1.render(sdl.renderer, TEXT_DISPLACEMENT, TEXT_DISPLACEMENT);
-		sdl.text_texture2.render(sdl.renderer, TEXT_DISPLACEMENT, TEXT_LINE_HEIGHT + TEXT_DISPLACEMENT);
-		sdl.text_texture3.render(sdl.renderer, TEXT_DISPLACEMENT, 2 * TEXT_LINE_HEIGHT + TEXT_DISPLACEMENT);
+		// ping-pong buffers, applying any spawns and despawns
+		physics.swapBuffers();
 
-		// flip buffer
-		SDL_RenderPresent(sdl.renderer);
+#ifdef STATE_FEED
+		feed.publish(physics);
+#endif
 
-		// ping-pong buffers
-		Boid* temp = physics.in;
-		physics.in = physics.out;
-		physics.out = temp;
+#ifdef CHECKPOINT_INTERVAL_STEPS
+		if (physics.step_count % CHECKPOINT_INTERVAL_STEPS == 0) checkpointer.saveAsync(physics, CHECKPOINT_FILE);
+#endif
 
 	} // main loop
 
 	return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
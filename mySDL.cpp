@@ -55,7 +55,7 @@ void LTexture::render(SDL_Renderer* renderer, const int x, const int y, const SD
 	SDL_RenderCopyEx(renderer, mTexture, clip, &renderQuad, angle, center, flip);
 }
 
-bool mySDL::loadFonts(const int num_CPU) {
+bool mySDL::loadFonts(const std::string& threads) {
 	font = TTF_OpenFont(FONT_NAME, FONT_SIZE);
 	if (!font) {
 		std::cerr << "ERROR: Failed to load font! SDL_ttf Error: " << TTF_GetError() << ". Aborting." << std::endl;
@@ -67,7 +67,7 @@ bool mySDL::loadFonts(const int num_CPU) {
 		return false;
 	}
 
-	if (!text_texture2.loadFromRenderedText(font, renderer, "Threads: " + std::to_string(num_CPU), TEXT_COLOR)) {
+	if (!text_texture2.loadFromRenderedText(font, renderer, "Threads: " + threads, TEXT_COLOR)) {
 		std::cerr << "Failed to render text texture! Aborting." << std::endl;
 		return false;
 	}
@@ -100,11 +100,17 @@ bool mySDL::initSDL(float& fWidth, float& fHeight) {
 	}
 
 	// create renderer
-	if (!(renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED))) {
+	if (!(renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE))) {
 		std::cerr << "ERROR: Renderer could not be created! SDL Error: " << SDL_GetError() << ". Aborting." << std::endl;
 		return false;
 	}
 
+	// create canvas
+	if (!(canvas = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height))) {
+		std::cerr << "ERROR: Canvas could not be created! SDL Error: " << SDL_GetError() << ". Aborting." << std::endl;
+		return false;
+	}
+
 	// init font engine
 	if (TTF_Init() == -1) {
 		std::cerr << "ERROR: SDL_ttf could not initialize! SDL_ttf Error: " << TTF_GetError() << ". Aborting." << std::endl;
@@ -119,12 +125,204 @@ bool mySDL::initSDL(float& fWidth, float& fHeight) {
 
 void mySDL::saveScreenshotBMP(const std::string& file_path) {
 	SDL_Surface* sshot = SDL_CreateRGBSurface(0, width, height, 32, 0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000);
+
+	// read the canvas, which unlike the back buffer
+	// still holds the last frame after a present
+	SDL_SetRenderTarget(renderer, canvas);
 	SDL_RenderReadPixels(renderer, nullptr, SDL_PIXELFORMAT_ARGB8888, sshot->pixels, sshot->pitch);
+	SDL_SetRenderTarget(renderer, nullptr);
+
 	SDL_SaveBMP(sshot, file_path.c_str());
 	SDL_FreeSurface(sshot);
 }
 
+void mySDL::drawScene(Physics& physics, const Boid* const boids, const bool blank) {
+	SDL_SetRenderTarget(renderer, canvas);
+
+	// clear screen
+	if (blank) {
+		SDL_SetRenderDrawColor(renderer, BLANKING_COLOR, SDL_ALPHA_OPAQUE);
+		SDL_RenderClear(renderer);
+	}
+
+#ifdef FIELD_MODE
+	renderField(*physics.field, physics.fWidth, physics.fHeight);
+#endif
+
+	// draw lines
+#ifndef DYNAMIC_COLOR_MODE
+	SDL_SetRenderDrawColor(renderer, BOID_COLOR_IF_NOT_DYNAMIC_MODE, SDL_ALPHA_OPAQUE);
+#endif
+
+	for (int i = 0; i < physics.num_boids; ++i) {
+#ifdef DYNAMIC_COLOR_MODE
+		SDL_SetRenderDrawColor(renderer, boids[i].color.R, boids[i].color.G, boids[i].color.B, SDL_ALPHA_OPAQUE);
+#endif
+		SDL_RenderDrawLine(renderer, boids[i].draw_x1, boids[i].draw_y1, boids[i].draw_x2, boids[i].draw_y2);
+	}
+
+	SDL_SetRenderTarget(renderer, nullptr);
+}
+
+#ifdef MODE_3D
+void mySDL::drawScene(Physics3D& physics, const Boid3D* const boids, const bool blank) {
+	SDL_SetRenderTarget(renderer, canvas);
+
+	// clear screen
+	if (blank) {
+		SDL_SetRenderDrawColor(renderer, BLANKING_COLOR, SDL_ALPHA_OPAQUE);
+		SDL_RenderClear(renderer);
+	}
+
+	// draw lines, depth-shaded
+	for (int i = 0; i < physics.num_boids; ++i) {
+		SDL_SetRenderDrawColor(renderer, boids[i].R, boids[i].G, boids[i].B, SDL_ALPHA_OPAQUE);
+		SDL_RenderDrawLine(renderer, boids[i].draw_x1, boids[i].draw_y1, boids[i].draw_x2, boids[i].draw_y2);
+	}
+
+	SDL_SetRenderTarget(renderer, nullptr);
+}
+#endif
+
+void mySDL::present() {
+	SDL_RenderCopy(renderer, canvas, nullptr, nullptr);
+
+	// draw text, one row per line actually shown, so
+	// optional lines that are compiled out leave no gap
+	int row = 0;
+	text_texture1.render(renderer, TEXT_DISPLACEMENT, row++ * TEXT_LINE_HEIGHT + TEXT_DISPLACEMENT);
+	text_texture2.render(renderer, TEXT_DISPLACEMENT, row++ * TEXT_LINE_HEIGHT + TEXT_DISPLACEMENT);
+	text_texture3.render(renderer, TEXT_DISPLACEMENT, row++ * TEXT_LINE_HEIGHT + TEXT_DISPLACEMENT);
+#ifdef FLOCK_ANALYTICS
+	text_texture4.render(renderer, TEXT_DISPLACEMENT, row++ * TEXT_LINE_HEIGHT + TEXT_DISPLACEMENT);
+#endif
+	text_texture5.render(renderer, TEXT_DISPLACEMENT, row++ * TEXT_LINE_HEIGHT + TEXT_DISPLACEMENT);
+	text_texture6.render(renderer, TEXT_DISPLACEMENT, row * TEXT_LINE_HEIGHT + TEXT_DISPLACEMENT);
+
+	// flip buffer
+	SDL_RenderPresent(renderer);
+}
+
+bool mySDL::setPresentMode(const PresentMode mode) {
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	if (SDL_RenderSetVSync(renderer, mode == PRESENT_VSYNC)) {
+		std::cerr << "ERROR: unable to switch to " << (mode == PRESENT_VSYNC ? "vsync" : "no vsync") << ". SDL Error: " << SDL_GetError() << '.' << std::endl;
+		return false;
+	}
+#else
+	// vsync can only be chosen at renderer creation before 2.0.18
+	if (mode == PRESENT_VSYNC) {
+		std::cerr << "ERROR: switching to vsync needs SDL 2.0.18 or later." << std::endl;
+		return false;
+	}
+#endif
+
+	present_mode = mode;
+	next_frame = 0;
+	return true;
+}
+
+void mySDL::cyclePresentMode() {
+	int mode = (present_mode + 1) % NUM_PRESENT_MODES;
+	while (mode != present_mode && !setPresentMode(static_cast<PresentMode>(mode))) mode = (mode + 1) % NUM_PRESENT_MODES;
+}
+
+const char* mySDL::presentModeName() const {
+	switch (present_mode) {
+	case PRESENT_VSYNC:
+		return "vsync";
+	case PRESENT_CAPPED:
+		return "capped";
+	default:
+		return "immediate";
+	}
+}
+
+void mySDL::waitForFrameSlot() {
+	if (present_mode != PRESENT_CAPPED) return;
+
+	const Uint64 freq = SDL_GetPerformanceFrequency();
+	Uint64 now = SDL_GetPerformanceCounter();
+
+	if (next_frame > now) {
+		// SDL_Delay is only good to a ms or so,
+		// so sleep most of the way and spin the rest
+		const Uint32 ms = static_cast<Uint32>((next_frame - now) * MS_PER_SECOND / freq);
+		if (ms > 1) SDL_Delay(ms - 1);
+		while ((now = SDL_GetPerformanceCounter()) < next_frame);
+	}
+
+	// if we fell behind, don't try to catch up
+	next_frame = std::max(next_frame, now) + freq / FRAME_CAP_FPS;
+}
+
+#ifdef FIELD_MODE
+void mySDL::loadObstacleBitmap(const std::string& path, Field& field) {
+	SDL_Surface* raw = SDL_LoadBMP(path.c_str());
+	if (!raw) return;
+
+	SDL_Surface* sfc = SDL_ConvertSurfaceFormat(raw, SDL_PIXELFORMAT_ARGB8888, 0);
+	SDL_FreeSurface(raw);
+	if (!sfc) {
+		std::cerr << "WARN: unable to convert obstacle bitmap " << path << ". SDL Error: " << SDL_GetError() << '.' << std::endl;
+		return;
+	}
+
+	// any pixel with some color in it is an obstacle
+	std::vector<uint8_t> mask(sfc->w * sfc->h);
+	SDL_LockSurface(sfc);
+	for (int j = 0; j < sfc->h; ++j) {
+		const uint32_t* row = reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(sfc->pixels) + j * sfc->pitch);
+		for (int i = 0; i < sfc->w; ++i) mask[j * sfc->w + i] = (row[i] & 0x00ffffff) != 0;
+	}
+	SDL_UnlockSurface(sfc);
+
+	field.addObstacleMask(mask.data(), sfc->w, sfc->h);
+	SDL_FreeSurface(sfc);
+}
+
+void mySDL::renderField(Field& field, const float fWidth, const float fHeight) {
+	if (field.mask_changed) {
+		if (!field_texture) {
+			field_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, FIELD_RESOLUTION, FIELD_RESOLUTION);
+			SDL_SetTextureBlendMode(field_texture, SDL_BLENDMODE_BLEND);
+		}
+
+		void* pixels;
+		int pitch;
+		if (field_texture && !SDL_LockTexture(field_texture, nullptr, &pixels, &pitch)) {
+			const SDL_Color obstacle = { OBSTACLE_COLOR };
+			const uint32_t on = 0xff000000 | (obstacle.r << 16) | (obstacle.g << 8) | obstacle.b;
+			for (int j = 0; j < FIELD_RESOLUTION; ++j) {
+				uint32_t* row = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(pixels) + j * pitch);
+				for (int i = 0; i < FIELD_RESOLUTION; ++i) row[i] = field.obstacle_mask[j * FIELD_RESOLUTION + i] ? on : 0;
+			}
+			SDL_UnlockTexture(field_texture);
+		}
+
+		field.mask_changed = false;
+	}
+
+	if (field_texture) SDL_RenderCopy(renderer, field_texture, nullptr, nullptr);
+
+	// attractors are small squares
+	SDL_SetRenderDrawColor(renderer, ATTRACTOR_COLOR, SDL_ALPHA_OPAQUE);
+	for (const Attractor& a : field.attractors) {
+		SDL_Rect r = { static_cast<int>(fWidth * a.x / fP_MAX) - LINE_LENGTH / 2, static_cast<int>(fHeight * a.y / fP_MAX) - LINE_LENGTH / 2, LINE_LENGTH, LINE_LENGTH };
+		SDL_RenderDrawRect(renderer, &r);
+	}
+}
+#endif
+
 mySDL::~mySDL() {
+	if (canvas) SDL_DestroyTexture(canvas);
+	canvas = nullptr;
+
+#ifdef FIELD_MODE
+	if (field_texture) SDL_DestroyTexture(field_texture);
+	field_texture = nullptr;
+#endif
+
 	SDL_DestroyRenderer(renderer);
 	renderer = nullptr;
 
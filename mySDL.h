@@ -14,6 +14,7 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include <SDL.h>
 #include <SDL_ttf.h>
@@ -21,6 +22,25 @@
 #include "Boids.h"
 #include "params.h"
 
+#ifdef MODE_3D
+#include "Boids3D.h"
+#endif
+
+// how frames reach the screen, cycled with V
+enum PresentMode {
+	// no vsync: lowest latency, may tear. SDL has no mailbox
+	// mode, so this is the closest to one
+	PRESENT_IMMEDIATE,
+
+	// wait for vertical blank
+	PRESENT_VSYNC,
+
+	// no vsync, but sleep to hold FRAME_CAP_FPS
+	PRESENT_CAPPED,
+
+	NUM_PRESENT_MODES
+};
+
 class LTexture {
 public:
 	LTexture() : mTexture(nullptr) {}
@@ -49,17 +69,28 @@ public:
 	LTexture text_texture1;
 	LTexture text_texture2;
 	LTexture text_texture3;
+	LTexture text_texture4;
+	LTexture text_texture5;
+	LTexture text_texture6;
 
 	SDL_Renderer* renderer;
 
 	TTF_Font* font;
 
+	PresentMode present_mode;
+
 private:
 
 	SDL_Window* window;
 
 	int width, height;
 
+	// render target holding the last drawn scene, without overlay
+	SDL_Texture* canvas;
+
+	// performance counter value when the next capped frame is due
+	Uint64 next_frame;
+
 public:
 	// Singleton idiom - only one
 	// instance of this class is permitted
@@ -72,7 +103,8 @@ public:
 
 	~mySDL();
 
-	bool loadFonts(const int num_CPU);
+	// threads is shown after "Threads: "
+	bool loadFonts(const std::string& threads);
 
 	// start up SDL and creates window
 	bool initSDL(float& fWidth, float& fHeight);
@@ -83,8 +115,56 @@ public:
 	// to save each shot
 	void saveScreenshotBMP(const std::string& file_path);
 
+	// draw field and boids into the canvas, which keeps them
+	// between frames (so without blank, boids leave trails)
+	void drawScene(Physics& physics, const Boid* const boids, const bool blank);
+
+#ifdef MODE_3D
+	// the same for projected 3D boids, in array order, which
+	// the grid sort keeps roughly back to front
+	void drawScene(Physics3D& physics, const Boid3D* const boids, const bool blank);
+#endif
+
+	// copy the canvas to the screen, draw the overlay on top and present.
+	// Cheap, so a static scene can be re-presented without redrawing it.
+	void present();
+
+	// switch present mode. Returns false (keeping the current
+	// mode) if the renderer can't change vsync.
+	bool setPresentMode(const PresentMode mode);
+
+	// switch to the next present mode the renderer accepts,
+	// skipping any it rejects (e.g. vsync before SDL 2.0.18)
+	void cyclePresentMode();
+
+	const char* presentModeName() const;
+
+	// in PRESENT_CAPPED, sleep until the next frame is due. Call at the
+	// top of the frame, before input is read, so the sleep doesn't
+	// add to input latency.
+	void waitForFrameSlot();
+
+#ifdef FIELD_MODE
+	// load a bitmap whose non-black pixels become obstacles,
+	// stretched over the whole field. Missing file is not an error.
+	void loadObstacleBitmap(const std::string& path, Field& field);
+
+	// draw obstacles (refreshing the cached texture if the mask changed)
+	// and attractor markers
+	void renderField(Field& field, const float fWidth, const float fHeight);
+#endif
+
 private:
-	mySDL() : renderer(nullptr), window(nullptr), font(nullptr) {}
+#ifdef FIELD_MODE
+	// obstacle mask, one texel per field cell, stretched to the screen
+	SDL_Texture* field_texture;
+#endif
+
+	mySDL() : renderer(nullptr), window(nullptr), font(nullptr), present_mode(PRESENT_IMMEDIATE), canvas(nullptr), next_frame(0)
+#ifdef FIELD_MODE
+		, field_texture(nullptr)
+#endif
+	{}
 
 	// NO copy construction or copy assignment. This is a singleton.
 	mySDL(const mySDL&) = delete;
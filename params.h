@@ -12,8 +12,6 @@
 #ifndef PARAMS_H
 #define PARAMS_H
 
-#include <SDL.h>
-
 //################ User-configurable Parameters ################
 
 // Recommended for performance and aesthetics
@@ -23,14 +21,50 @@
 
 #define DYNAMIC_COLOR_MODE
 
+// Precomputed obstacle/attractor force field (see Field.h)
+#define FIELD_MODE
+
+// Flock statistics built from the kernel's neighbor search (see Analytics.h).
+// Costs some step time and writes FLOCK_METRICS_FILE every step
+//#define FLOCK_ANALYTICS
+
+// Sample the mouse again after the physics step and apply it in a
+// cheap final pass, so it's one step fresher when presented. Changes
+// the physics: the mouse then acts after the neighbor rules, not before
+//#define LOW_LATENCY_INPUT
+
+// Pick thread count and chunking by timing a few steps at startup (see Autotune.h).
+// Delays the first launch per machine and population; caches to AUTOTUNE_CACHE_FILE
+//#define AUTOTUNE
+
+// Publish every step to POSIX shared memory (see StateFeed.h)
+//#define STATE_FEED
+
+// Simulate a 3D cube of boids, drawn in perspective (see Boids3D.h).
+// Turns off the 2D-only features: fields, analytics, late mouse,
+// autotune, state feed, checkpoints, species and spawning
+//#define MODE_3D
+
 // Integer defines
 #define		NUMBER_OF_BOIDS							(3500)
+#define		BOID_CAPACITY							(8192)
+#define		SPAWN_BATCH								(100)
+#define		COMPACTION_PARALLEL_MIN					(4096)
+#define		FRAME_CAP_FPS							(144)
+#define		LATENCY_SAMPLES							(256)
+#define		IDLE_WAIT_MS							(500)
+#define		MAX_SPECIES								(8)
 #define		LINE_LENGTH								(7)
 #define		FPS_UPDATE_MS							(100)
 #define		FONT_SIZE								(14)
 #define		TEXT_DISPLACEMENT						(3)
 #define		TEXT_LINE_HEIGHT						(18)
 //#define	OVERRIDE_CPU_COUNT_AUTODETECT			(1)
+//#define	CHECKPOINT_INTERVAL_STEPS				(3000)
+#define		STATE_FEED_SLOTS						(4)
+#define		FLOCK_MIN_SIZE							(3)
+#define		AUTOTUNE_STEPS							(5)
+#define		AUTOTUNE_WARMUP_STEPS					(1)
 
 // Float defines
 #define		V_LIM									(220.0f)
@@ -41,19 +75,46 @@
 #define		CENTER_OF_MASS_STRENGTH_FACTOR			(0.2f)
 #define		WEAK_MOUSE_DOWN_STRENGTH_FACTOR			(150.0f)
 #define		STRONG_DOWN_STRENGTH_FACTOR				(9000.0f)
+#define		AUTOTUNE_FRAME_MS						(16.0f)
+#define		CAMERA_3D_DISTANCE						(20000.0f)
+#define		DEPTH_SHADE_3D_MIN						(0.25f)
+
+// Field defines
+#define		FIELD_RESOLUTION						(256)
+#define		FIELD_INFLUENCE_DISTANCE				(400.0f)
+#define		FIELD_OBSTACLE_STRENGTH_FACTOR			(3000.0f)
+#define		FIELD_ATTRACTOR_STRENGTH_FACTOR			(150.0f)
+#define		FIELD_OBSTACLE_DISC_RADIUS				(250.0f)
 
 // Color defines
 #define		BLANKING_COLOR							0, 0, 0
 #define		BOID_COLOR_IF_NOT_DYNAMIC_MODE			0, 0, 255
 #define		TEXT_COLOR								{ 255, 0, 0 }
+#define		OBSTACLE_COLOR							90, 90, 90
+#define		ATTRACTOR_COLOR							255, 255, 255
 
 // Other defines
 #define		FONT_NAME								"FreeSansBold.ttf"
 #define		ICON_FILE								"boid.bmp"
+#define		OBSTACLE_FILE							"obstacles.bmp"
+#define		CHECKPOINT_FILE							"checkpoint.boids"
+#define		STATE_FEED_NAME							"/boids_state"
+#define		FLOCK_METRICS_FILE						"flock_metrics.csv"
+#define		AUTOTUNE_CACHE_FILE						"autotune.cache"
+#define		SPECIES_FILE							"species.txt"
 #define		WINDOW_TITLE							"Boids"
 
 //##############################################################
 
+#ifdef MODE_3D
+#undef FIELD_MODE
+#undef FLOCK_ANALYTICS
+#undef LOW_LATENCY_INPUT
+#undef AUTOTUNE
+#undef STATE_FEED
+#undef CHECKPOINT_INTERVAL_STEPS
+#endif
+
 #ifdef FULL_SCREEN
 #define SDL_FLAGS (SDL_WINDOW_FULLSCREEN_DESKTOP | SDL_WINDOW_SHOWN)
 #else
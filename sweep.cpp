@@ -0,0 +1,252 @@
+/*******************************************************************
+*   sweep.cpp
+*   Boids
+*	agent
+*
+*	10/19/2026
+*******************************************************************/
+
+// Headless parameter sweeps: runs many worlds side by side in one
+// Ensemble (see Ensemble.h) and prints one CSV line of summary
+// metrics per world. Does not need SDL, e.g.:
+//
+//	g++ -std=c++14 -O3 -pthread Analytics.cpp sweep.cpp Boids.cpp Ensemble.cpp Field.cpp Species.cpp -o sweep
+//
+// Usage:
+//	sweep [--steps <n>] [--dt <ms>] [--threads <n>] [--seed <s>] [--replicates <n>]
+//	      [--boids <n>] [--worlds <file>] [--vary <name>=<from>:<to>:<count>]...
+//
+//	--steps			-	steps per world (default 600)
+//	--dt			-	milliseconds per step (default 16)
+//	--threads		-	worker threads shared by all worlds (default all)
+//	--seed			-	spawn seed; every parameter set starts from the
+//						same positions for a like-for-like comparison
+//	--replicates	-	run each parameter set this many times, with
+//						seeds seed, seed + 1, ...
+//	--boids			-	default population per world
+//	--worlds		-	file of parameter sets, one per line, as
+//						name=value pairs; anything unset is the default
+//	--vary			-	sweep a parameter over count evenly spaced values.
+//						Several --vary give every combination.
+//
+// Parameter names: boids, v_lim, tick_factor, alignment, repulsion,
+// edge_repulsion, center_of_mass.
+//
+// Flock metrics are averaged over the second half of the run, once
+// the flocks have had time to form. With FLOCK_ANALYTICS the kernel
+// finds them every step; otherwise Ensemble::measureFlocks does, every
+// SWEEP_MEASURE_INTERVAL steps, as it costs about a step each time.
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Ensemble.h"
+
+#define SWEEP_DEFAULT_STEPS			(600)
+#define SWEEP_DEFAULT_DT			(16.0f)
+#define SWEEP_DEFAULT_SEED			(1)
+#define SWEEP_MEASURE_INTERVAL		(10)
+
+struct WorldSpec {
+	SimParams params;
+	int num_boids;
+};
+
+struct WorldSummary {
+	double flocks, largest_size, polarization;
+	int samples;
+};
+
+static bool setParam(WorldSpec& spec, const std::string& name, const float value) {
+	if (name == "boids") spec.num_boids = static_cast<int>(value);
+	else if (name == "v_lim") spec.params.v_lim = value;
+	else if (name == "tick_factor") spec.params.tick_factor = value;
+	else if (name == "alignment") spec.params.alignment = value;
+	else if (name == "repulsion") spec.params.repulsion = value;
+	else if (name == "edge_repulsion") spec.params.edge_repulsion = value;
+	else if (name == "center_of_mass") spec.params.center_of_mass = value;
+	else return false;
+	return true;
+}
+
+static bool parseAssignment(const std::string& token, std::string& name, std::string& value) {
+	const size_t eq = token.find('=');
+	if (eq == std::string::npos) return false;
+	name = token.substr(0, eq);
+	value = token.substr(eq + 1);
+	return true;
+}
+
+static bool loadWorlds(const std::string& path, const WorldSpec& defaults, std::vector<WorldSpec>& specs) {
+	std::ifstream f(path);
+	if (!f) {
+		std::cerr << "ERROR: unable to open " << path << '.' << std::endl;
+		return false;
+	}
+
+	std::string line, token, name, value;
+	for (int line_num = 1; std::getline(f, line); ++line_num) {
+		line = line.substr(0, line.find('#'));
+		std::istringstream ss(line);
+		WorldSpec spec = defaults;
+		bool any = false;
+
+		while (ss >> token) {
+			if (!parseAssignment(token, name, value) || !setParam(spec, name, strtof(value.c_str(), nullptr))) {
+				std::cerr << "ERROR: " << path << ':' << line_num << ": bad parameter " << token << '.' << std::endl;
+				return false;
+			}
+			any = true;
+		}
+
+		if (any) specs.push_back(spec);
+	}
+
+	return true;
+}
+
+// expand each spec into count copies with name set from..to
+static bool vary(const std::string& arg, std::vector<WorldSpec>& specs) {
+	std::string name, range;
+	float from, to;
+	int count;
+	char c1, c2;
+
+	std::istringstream ss;
+	if (parseAssignment(arg, name, range)) ss.str(range);
+	if (!(ss >> from >> c1 >> to >> c2 >> count) || c1 != ':' || c2 != ':' || count < 1) {
+		std::cerr << "ERROR: bad --vary " << arg << ", expected name=from:to:count." << std::endl;
+		return false;
+	}
+
+	std::vector<WorldSpec> expanded;
+	for (const WorldSpec& spec : specs) {
+		for (int i = 0; i < count; ++i) {
+			WorldSpec s = spec;
+			if (!setParam(s, name, count == 1 ? from : from + (to - from) * i / (count - 1))) {
+				std::cerr << "ERROR: unknown parameter " << name << '.' << std::endl;
+				return false;
+			}
+			expanded.push_back(s);
+		}
+	}
+
+	specs.swap(expanded);
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	_MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+
+	int steps = SWEEP_DEFAULT_STEPS;
+	float dt = SWEEP_DEFAULT_DT;
+	int num_threads = 0;
+	unsigned int seed = SWEEP_DEFAULT_SEED;
+	int replicates = 1;
+
+	WorldSpec defaults;
+	defaults.num_boids = NUMBER_OF_BOIDS;
+
+	std::string worlds_file;
+	std::vector<std::string> varies;
+
+	for (int i = 1; i < argc; ++i) {
+		if (!strcmp(argv[i], "--steps") && i + 1 < argc) steps = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--dt") && i + 1 < argc) dt = static_cast<float>(atof(argv[++i]));
+		else if (!strcmp(argv[i], "--threads") && i + 1 < argc) num_threads = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10));
+		else if (!strcmp(argv[i], "--replicates") && i + 1 < argc) replicates = std::max(1, atoi(argv[++i]));
+		else if (!strcmp(argv[i], "--boids") && i + 1 < argc) defaults.num_boids = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--worlds") && i + 1 < argc) worlds_file = argv[++i];
+		else if (!strcmp(argv[i], "--vary") && i + 1 < argc) varies.push_back(argv[++i]);
+		else {
+			std::cerr << "ERROR: unknown argument " << argv[i] << '.' << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::vector<WorldSpec> specs;
+	if (!worlds_file.empty()) {
+		if (!loadWorlds(worlds_file, defaults, specs)) return EXIT_FAILURE;
+	}
+	else {
+		specs.push_back(defaults);
+	}
+
+	for (const std::string& v : varies) {
+		if (!vary(v, specs)) return EXIT_FAILURE;
+	}
+
+	Ensemble ensemble;
+	ensemble.initThreads(num_threads);
+
+	std::vector<unsigned int> seeds;
+	for (const WorldSpec& spec : specs) {
+		for (int r = 0; r < replicates; ++r) {
+			ensemble.addWorld(spec.params, spec.num_boids, seed + r);
+			seeds.push_back(seed + r);
+		}
+	}
+
+	std::vector<WorldSummary> summaries(ensemble.size(), WorldSummary{ 0.0, 0.0, 0.0, 0 });
+	long long total_boids = 0;
+	for (int w = 0; w < ensemble.size(); ++w) total_boids += ensemble.world(w).num_boids;
+
+	std::cerr << "Running " << ensemble.size() << " worlds (" << total_boids << " boids) for " << steps << " steps on " << ensemble.num_CPU << " threads..." << std::endl;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+#ifndef FLOCK_ANALYTICS
+	FlockStats fs;
+#endif
+
+	for (int s = 0; s < steps; ++s) {
+		ensemble.step(dt);
+
+		if (s < steps / 2) continue;
+#ifndef FLOCK_ANALYTICS
+		// counted back from the last step, so that's always measured
+		if ((steps - 1 - s) % SWEEP_MEASURE_INTERVAL) continue;
+#endif
+
+		for (int w = 0; w < ensemble.size(); ++w) {
+#ifdef FLOCK_ANALYTICS
+			const FlockStats& fs = ensemble.world(w).flock_stats;
+#else
+			ensemble.measureFlocks(w, fs);
+#endif
+			summaries[w].flocks += fs.flocks;
+			summaries[w].largest_size += fs.largest_size;
+			summaries[w].polarization += fs.polarization;
+			++summaries[w].samples;
+		}
+	}
+
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cerr << "Done in " << seconds << " s (" << 1000.0 * seconds / std::max(steps, 1) << " ms per ensemble step)." << std::endl;
+
+	std::cout << "world,seed,boids,v_lim,tick_factor,alignment,repulsion,edge_repulsion,center_of_mass,mean_speed,flocks,largest_size,polarization\n";
+
+	for (int w = 0; w < ensemble.size(); ++w) {
+		const Physics& world = ensemble.world(w);
+		const SimParams& p = world.params;
+
+		double speed = 0.0;
+		for (int i = 0; i < world.num_boids; ++i) speed += sqrt(world.in[i].vx * world.in[i].vx + world.in[i].vy * world.in[i].vy);
+
+		std::cout << w << ',' << seeds[w] << ',' << world.num_boids << ',' << p.v_lim << ',' << p.tick_factor << ',' << p.alignment << ',' << p.repulsion << ','
+			<< p.edge_repulsion << ',' << p.center_of_mass << ',' << speed / world.num_boids;
+
+		const int n = std::max(summaries[w].samples, 1);
+		std::cout << ',' << summaries[w].flocks / n << ',' << summaries[w].largest_size / n << ',' << summaries[w].polarization / n << '\n';
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,477 @@
+/*******************************************************************
+*   validate.cpp
+*   Boids
+*	agent
+*
+*	10/19/2026
+*******************************************************************/
+
+// Golden-state validation for physics kernels. A plain scalar
+// reference step, written straight from the rules with no tricks,
+// is run side by side with each candidate kernel from identical
+// seeded state. Every step, per-boid positions and velocities are
+// compared with ULP and absolute tolerances, and the worst offenders
+// are reported. Both sides always start each step from the same
+// (reference) state so chaotic divergence doesn't mask real bugs.
+// The 3D grid kernel is checked the same way against a brute-force
+// 3D reference, so a neighbor the grid misses shows up as a mismatch.
+// Does not need SDL, e.g.:
+//
+//	g++ -std=c++14 -O2 -pthread Analytics.cpp validate.cpp Boids.cpp Boids3D.cpp Checkpoint.cpp Field.cpp Species.cpp -o validate
+//
+// Usage:
+//	validate [--seed <n>] [--steps <n>] [--warmup <n>] [--boids <n>] [--threads <n>]
+//	         [--ulp <n>] [--abs <x>] [--worst <n>] [--mouse] [--checkpoint <file>]
+//	         [--wrap3d <axes>]
+//
+//	A value passes if it is within --ulp ULPs OR within --abs of
+//	the reference. Exits with failure if any value fails.
+//	--mouse holds a button down, and also checks the late mouse
+//	pass (LOW_LATENCY_INPUT). --checkpoint starts from a saved
+//	flock (see Checkpoint.h) instead of a seeded spawn. --wrap3d
+//	lists the 3D axes that wrap, e.g. xz, or - for none (default:
+//	all, if SCREEN_WRAP).
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Boids.h"
+#include "Boids3D.h"
+#include "Checkpoint.h"
+
+#define VALIDATE_DEFAULT_SEED		(1)
+#define VALIDATE_DEFAULT_STEPS		(20)
+#define VALIDATE_DEFAULT_WARMUP		(30)
+#define VALIDATE_DEFAULT_ULP		(64)
+#define VALIDATE_DEFAULT_ABS		(4e-3f)
+#define VALIDATE_DEFAULT_WORST		(10)
+#define VALIDATE_FRAME_MS			(16.0f)
+#define VALIDATE_SCREEN_WIDTH		(1920.0f)
+#define VALIDATE_SCREEN_HEIGHT		(1080.0f)
+
+// a candidate reads physics.in and writes physics.out. With
+// late_mouse, it's checked against a reference that applies the
+// mouse after the step, as Physics::applyLateMouse does.
+struct Candidate {
+	const char* name;
+	std::function<void(Physics&)> step;
+	bool late_mouse;
+};
+
+struct Mismatch {
+	int step, boid;
+	const char* field;
+	float ref, cand;
+	double abs_err;
+	int64_t ulps;
+};
+
+static const char* const FIELD_NAMES[4] = { "x", "y", "vx", "vy" };
+static const char* const FIELD_NAMES_3D[6] = { "x", "y", "z", "vx", "vy", "vz" };
+
+// reference mouse attraction/repulsion velocity change at (x, y)
+static void referenceMouse(const Physics& p, const float x, const float y, const float time_factor, float& dVx, float& dVy) {
+	float mx = static_cast<float>(p.mouse_x * P_MAX) / p.fWidth;
+	float my = static_cast<float>(p.mouse_y * P_MAX) / p.fHeight;
+#ifdef SCREEN_WRAP
+	float dx = diff(x, mx);
+	float dy = diff(y, my);
+#else
+	float dx = mx - x;
+	float dy = my - y;
+#endif
+	float strength = p.repulsion_multiplier * (p.repulsion_boost ? STRONG_DOWN_STRENGTH_FACTOR : WEAK_MOUSE_DOWN_STRENGTH_FACTOR);
+	float f = strength / (sqrt(dx*dx + dy*dy) + PREVENT_ZERO_RETURN);
+	dVx = time_factor * dx * f;
+	dVy = time_factor * dy * f;
+}
+
+// reference scalar step, straight from the rules. Deliberately kept
+// independent of Physics::processBoid so the two can catch each other.
+// late applies the mouse after the step instead of before it.
+static void referenceStep(const Physics& p, const Boid* const in, Boid* const out, const bool late = false) {
+	const int n = p.num_boids;
+	const float time_factor = TICK_FACTOR * p.time_since_last_frame;
+
+	for (int i = 0; i < n; ++i) {
+		float x = in[i].x, y = in[i].y, Vx = in[i].vx, Vy = in[i].vy;
+		float dx, dy, dVx, dVy;
+
+		if (p.mouse_buttons_down && !late) {
+			referenceMouse(p, x, y, time_factor, dVx, dVy);
+			Vx += dVx;
+			Vy += dVy;
+		}
+
+#ifdef FIELD_MODE
+		float fx, fy;
+		p.field->sample(x, y, fx, fy);
+		Vx += time_factor * fx;
+		Vy += time_factor * fy;
+#endif
+
+		// neighbors, excluding self
+		float cmx = 0.0f, cmy = 0.0f, repx = 0.0f, repy = 0.0f, alx = 0.0f, aly = 0.0f;
+		int neighbors = 1;
+		for (int j = 0; j < n; ++j) {
+			if (j == i) continue;
+#ifdef SCREEN_WRAP
+			dx = diff(x, in[j].x);
+			dy = diff(y, in[j].y);
+#else
+			dx = in[j].x - x;
+			dy = in[j].y - y;
+#endif
+			float d2 = dx*dx + dy*dy;
+			if (d2 >= NEIGHBOR_DISTANCE_SQUARED) continue;
+
+			cmx += dx;
+			cmy += dy;
+			repx -= dx / (d2 + PREVENT_ZERO_RETURN);
+			repy -= dy / (d2 + PREVENT_ZERO_RETURN);
+			alx += in[j].vx;
+			aly += in[j].vy;
+			++neighbors;
+		}
+
+#ifndef SCREEN_WRAP
+		if (x < NEIGHBOR_DISTANCE) repx += EDGE_REPULSION_STRENGTH_FACTOR * (NEIGHBOR_DISTANCE - x);
+		if (x > fP_MAX - NEIGHBOR_DISTANCE) repx -= EDGE_REPULSION_STRENGTH_FACTOR * (x - (fP_MAX - NEIGHBOR_DISTANCE));
+		if (y < NEIGHBOR_DISTANCE) repy += EDGE_REPULSION_STRENGTH_FACTOR * (NEIGHBOR_DISTANCE - y);
+		if (y > fP_MAX - NEIGHBOR_DISTANCE) repy -= EDGE_REPULSION_STRENGTH_FACTOR * (y - (fP_MAX - NEIGHBOR_DISTANCE));
+#endif
+
+		// averages count self as a neighbor, as the kernel does
+		Vx += time_factor * (CENTER_OF_MASS_STRENGTH_FACTOR * cmx / neighbors + REPULSION_STRENGTH_FACTOR * repx + ALIGNMENT_STRENGTH_FACTOR * alx / neighbors);
+		Vy += time_factor * (CENTER_OF_MASS_STRENGTH_FACTOR * cmy / neighbors + REPULSION_STRENGTH_FACTOR * repy + ALIGNMENT_STRENGTH_FACTOR * aly / neighbors);
+
+		float v2 = Vx*Vx + Vy*Vy;
+		if (v2 > V_LIM_2) {
+			Vx *= V_LIM / sqrt(v2);
+			Vy *= V_LIM / sqrt(v2);
+		}
+
+#ifdef SCREEN_WRAP
+		x += Vx * time_factor;
+		y += Vy * time_factor;
+		if (x < 0.0f) x += fP_MAX;
+		if (x >= fP_MAX) x -= fP_MAX;
+		if (y < 0.0f) y += fP_MAX;
+		if (y >= fP_MAX) y -= fP_MAX;
+#else
+		if (x < 0.0f) Vx = fabs(Vx);
+		if (x >= fP_MAX) Vx = -fabs(Vx);
+		if (y < 0.0f) Vy = fabs(Vy);
+		if (y >= fP_MAX) Vy = -fabs(Vy);
+		x += Vx * time_factor;
+		y += Vy * time_factor;
+#endif
+
+		// the mouse at the stepped position, then move by
+		// the difference it makes to the velocity
+		if (p.mouse_buttons_down && late) {
+			referenceMouse(p, x, y, time_factor, dVx, dVy);
+			float Wx = Vx + dVx, Wy = Vy + dVy;
+			float w2 = Wx*Wx + Wy*Wy;
+			if (w2 > V_LIM_2) {
+				Wx *= V_LIM / sqrt(w2);
+				Wy *= V_LIM / sqrt(w2);
+			}
+			x += (Wx - Vx) * time_factor;
+			y += (Wy - Vy) * time_factor;
+#ifdef SCREEN_WRAP
+			if (x < 0.0f) x += fP_MAX;
+			if (x >= fP_MAX) x -= fP_MAX;
+			if (y < 0.0f) y += fP_MAX;
+			if (y >= fP_MAX) y -= fP_MAX;
+#endif
+			Vx = Wx;
+			Vy = Wy;
+		}
+
+		out[i] = in[i];
+		out[i].x = x;
+		out[i].y = y;
+		out[i].vx = Vx;
+		out[i].vy = Vy;
+	}
+}
+
+// reference 3D step: every pair, nearest image on wrapped axes, no
+// grid. Without the mouse, which the 3D kernel places by unprojection.
+static void referenceStep3D(const Physics3D& p, const Boid3D* const in, Boid3D* const out) {
+	const int n = p.num_boids;
+	const float time_factor = TICK_FACTOR * p.time_since_last_frame;
+
+	for (int i = 0; i < n; ++i) {
+		float c[3] = { in[i].x, in[i].y, in[i].z }, V[3] = { in[i].vx, in[i].vy, in[i].vz };
+		float cm[3] = {}, rep[3] = {}, al[3] = {}, d[3];
+		int neighbors = 1;
+
+		// neighbors, excluding self
+		for (int j = 0; j < n; ++j) {
+			if (j == i) continue;
+			const float cj[3] = { in[j].x, in[j].y, in[j].z };
+			for (int a = 0; a < 3; ++a) {
+				d[a] = cj[a] - c[a];
+				if (p.wrap[a] && d[a] > fHALF_P_MAX) d[a] -= fP_MAX;
+				if (p.wrap[a] && d[a] < -fHALF_P_MAX) d[a] += fP_MAX;
+			}
+			float d2 = d[0]*d[0] + d[1]*d[1] + d[2]*d[2];
+			if (d2 >= NEIGHBOR_DISTANCE_SQUARED) continue;
+
+			const float vj[3] = { in[j].vx, in[j].vy, in[j].vz };
+			for (int a = 0; a < 3; ++a) {
+				cm[a] += d[a];
+				rep[a] -= d[a] / (d2 + PREVENT_ZERO_RETURN);
+				al[a] += vj[a];
+			}
+			++neighbors;
+		}
+
+		float v2 = 0.0f;
+		for (int a = 0; a < 3; ++a) {
+			float edge = 0.0f;
+			if (!p.wrap[a] && c[a] < NEIGHBOR_DISTANCE) edge += EDGE_REPULSION_STRENGTH_FACTOR * (NEIGHBOR_DISTANCE - c[a]);
+			if (!p.wrap[a] && c[a] > fP_MAX - NEIGHBOR_DISTANCE) edge -= EDGE_REPULSION_STRENGTH_FACTOR * (c[a] - (fP_MAX - NEIGHBOR_DISTANCE));
+			V[a] += time_factor * (CENTER_OF_MASS_STRENGTH_FACTOR * cm[a] / neighbors + REPULSION_STRENGTH_FACTOR * (rep[a] + edge) + ALIGNMENT_STRENGTH_FACTOR * al[a] / neighbors);
+			v2 += V[a] * V[a];
+		}
+
+		for (int a = 0; a < 3; ++a) {
+			if (v2 > V_LIM_2) V[a] *= V_LIM / sqrt(v2);
+
+			if (p.wrap[a]) {
+				c[a] += V[a] * time_factor;
+				if (c[a] < 0.0f) c[a] += fP_MAX;
+				if (c[a] >= fP_MAX) c[a] -= fP_MAX;
+			}
+			else {
+				if (c[a] < 0.0f) V[a] = fabs(V[a]);
+				if (c[a] >= fP_MAX) V[a] = -fabs(V[a]);
+				c[a] += V[a] * time_factor;
+			}
+		}
+
+		out[i] = in[i];
+		out[i].x = c[0];
+		out[i].y = c[1];
+		out[i].z = c[2];
+		out[i].vx = V[0];
+		out[i].vy = V[1];
+		out[i].vz = V[2];
+	}
+}
+
+// distance in representable floats between a and b
+static int64_t ulpDistance(const float a, const float b) {
+	int32_t ia, ib;
+	memcpy(&ia, &a, sizeof(ia));
+	memcpy(&ib, &b, sizeof(ib));
+
+	// remap sign-magnitude to a monotonic integer line
+	if (ia < 0) ia = INT32_MIN - ia;
+	if (ib < 0) ib = INT32_MIN - ib;
+
+	return std::abs(static_cast<int64_t>(ia) - static_cast<int64_t>(ib));
+}
+
+int main(int argc, char* argv[]) {
+	_MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+
+	unsigned int seed = VALIDATE_DEFAULT_SEED;
+	int steps = VALIDATE_DEFAULT_STEPS;
+	int warmup = VALIDATE_DEFAULT_WARMUP;
+	int boids = NUMBER_OF_BOIDS;
+	int threads = 0;
+	int64_t max_ulps = VALIDATE_DEFAULT_ULP;
+	double max_abs = VALIDATE_DEFAULT_ABS;
+	int worst = VALIDATE_DEFAULT_WORST;
+	bool mouse = false;
+	std::string checkpoint_path;
+#ifdef SCREEN_WRAP
+	std::string wrap3d = "xyz";
+#else
+	std::string wrap3d = "-";
+#endif
+
+	for (int i = 1; i < argc; ++i) {
+		if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = static_cast<unsigned int>(atoi(argv[++i]));
+		else if (!strcmp(argv[i], "--steps") && i + 1 < argc) steps = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--warmup") && i + 1 < argc) warmup = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--boids") && i + 1 < argc) boids = std::min(std::max(atoi(argv[++i]), 1), BOID_CAPACITY);
+		else if (!strcmp(argv[i], "--threads") && i + 1 < argc) threads = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--ulp") && i + 1 < argc) max_ulps = atoll(argv[++i]);
+		else if (!strcmp(argv[i], "--abs") && i + 1 < argc) max_abs = atof(argv[++i]);
+		else if (!strcmp(argv[i], "--worst") && i + 1 < argc) worst = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--mouse")) mouse = true;
+		else if (!strcmp(argv[i], "--checkpoint") && i + 1 < argc) checkpoint_path = argv[++i];
+		else if (!strcmp(argv[i], "--wrap3d") && i + 1 < argc) wrap3d = argv[++i];
+		else {
+			fprintf(stderr, "Usage: %s [--seed <n>] [--steps <n>] [--warmup <n>] [--boids <n>] [--threads <n>] [--ulp <n>] [--abs <x>] [--worst <n>] [--mouse] [--checkpoint <file>] [--wrap3d <axes>]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	Physics& physics = Physics::getInstance();
+	physics.fWidth = VALIDATE_SCREEN_WIDTH;
+	physics.fHeight = VALIDATE_SCREEN_HEIGHT;
+	physics.time_since_last_frame = VALIDATE_FRAME_MS;
+	physics.num_boids = boids;
+	physics.initThreads(threads);
+
+	if (mouse) {
+		physics.mouse_buttons_down = 1;
+		physics.mouse_x = static_cast<int>(VALIDATE_SCREEN_WIDTH / 3);
+		physics.mouse_y = static_cast<int>(VALIDATE_SCREEN_HEIGHT / 3);
+	}
+
+#ifdef FIELD_MODE
+	// exercise the field path too
+	physics.field->addObstacleDisc(fHALF_P_MAX, fHALF_P_MAX, FIELD_OBSTACLE_DISC_RADIUS);
+	physics.field->addAttractor(fP_MAX / 4, fP_MAX / 4, FIELD_ATTRACTOR_STRENGTH_FACTOR);
+	physics.field->update();
+#endif
+
+	std::vector<Candidate> candidates = {
+		{ "processRules", [](Physics& p) { p.processRules(); }, false },
+		{ "processBoid (serial)", [](Physics& p) { for (int i = 0; i < p.num_boids; ++i) p.processBoid(i); }, false },
+	};
+
+	// the LOW_LATENCY_INPUT path
+	if (mouse) candidates.push_back({ "processRules+lateMouse", [](Physics& p) { p.late_mouse = true; p.processRules(); p.applyLateMouse(); p.late_mouse = false; }, true });
+
+	// seeded (or checkpointed) initial state, warmed up by the
+	// reference so velocities and clusters are representative
+	if (!checkpoint_path.empty()) {
+		if (!Checkpointer::restore(physics, checkpoint_path)) return EXIT_FAILURE;
+		boids = physics.num_boids;
+	}
+	else {
+		physics.seedRNG(seed);
+		physics.spawnBoids();
+	}
+	std::vector<Boid> ref(physics.in, physics.in + boids), next(boids);
+	for (int i = 0; i < warmup; ++i) {
+		referenceStep(physics, ref.data(), next.data());
+		ref.swap(next);
+	}
+	const std::vector<Boid> start = ref;
+
+	printf("seed %u, %d boids, %d threads, %d warm-up + %d steps, tolerance %lld ulp or %g abs\n\n", seed, boids, physics.num_CPU, warmup, steps, static_cast<long long>(max_ulps), max_abs);
+
+	bool all_passed = true;
+	for (const Candidate& c : candidates) {
+		std::vector<Mismatch> worst_seen;
+		int64_t failures = 0, max_ulps_seen = 0;
+		double max_abs_seen = 0.0;
+
+		ref = start;
+		for (int s = 0; s < steps; ++s) {
+			std::copy(ref.begin(), ref.end(), physics.in);
+			c.step(physics);
+			referenceStep(physics, ref.data(), next.data(), c.late_mouse);
+
+			for (int i = 0; i < boids; ++i) {
+				const float r[4] = { next[i].x, next[i].y, next[i].vx, next[i].vy };
+				const float k[4] = { physics.out[i].x, physics.out[i].y, physics.out[i].vx, physics.out[i].vy };
+
+				for (int f = 0; f < 4; ++f) {
+					double abs_err = fabs(static_cast<double>(k[f]) - r[f]);
+#ifdef SCREEN_WRAP
+					// positions that wrapped on one side only are still neighbors
+					if (f < 2) abs_err = std::min(abs_err, fP_MAX - abs_err);
+#endif
+					int64_t ulps = ulpDistance(r[f], k[f]);
+					max_abs_seen = std::max(max_abs_seen, abs_err);
+					max_ulps_seen = std::max(max_ulps_seen, ulps);
+
+					if (ulps <= max_ulps || abs_err <= max_abs) continue;
+
+					++failures;
+					Mismatch m = { s, i, FIELD_NAMES[f], r[f], k[f], abs_err, ulps };
+					worst_seen.push_back(m);
+				}
+			}
+
+			// worst offenders first, by absolute error
+			std::sort(worst_seen.begin(), worst_seen.end(), [](const Mismatch& a, const Mismatch& b) { return a.abs_err > b.abs_err; });
+			if (static_cast<int>(worst_seen.size()) > worst) worst_seen.resize(worst);
+
+			ref.swap(next);
+		}
+
+		printf("%-24s %s  max abs %.3g, max ulp %lld, %lld value(s) out of tolerance\n", c.name, failures ? "FAIL" : "PASS", max_abs_seen, static_cast<long long>(max_ulps_seen), static_cast<long long>(failures));
+		for (const Mismatch& m : worst_seen)
+			printf("    step %3d  boid %5d  %-2s  ref % .9g  got % .9g  abs %.3g  ulp %lld\n", m.step, m.boid, m.field, m.ref, m.cand, m.abs_err, static_cast<long long>(m.ulps));
+
+		all_passed &= !failures;
+	}
+
+	// the 3D grid kernel, from its own seeded spawn. processRules
+	// sorts in into the grid first, so the reference reads the
+	// sorted in to compare index for index.
+	{
+		Physics3D& physics3d = Physics3D::getInstance();
+		physics3d.fWidth = VALIDATE_SCREEN_WIDTH;
+		physics3d.fHeight = VALIDATE_SCREEN_HEIGHT;
+		physics3d.time_since_last_frame = VALIDATE_FRAME_MS;
+		physics3d.num_boids = boids;
+		for (int a = 0; a < 3; ++a) physics3d.wrap[a] = wrap3d.find("xyz"[a]) != std::string::npos;
+		physics3d.initThreads(threads);
+		physics3d.seedRNG(seed);
+		physics3d.spawnBoids();
+
+		std::vector<Boid3D> ref3d(physics3d.in, physics3d.in + boids), next3d(boids);
+		for (int i = 0; i < warmup; ++i) {
+			referenceStep3D(physics3d, ref3d.data(), next3d.data());
+			ref3d.swap(next3d);
+		}
+
+		std::vector<Mismatch> worst_seen;
+		int64_t failures = 0, max_ulps_seen = 0;
+		double max_abs_seen = 0.0;
+
+		for (int s = 0; s < steps; ++s) {
+			std::copy(ref3d.begin(), ref3d.end(), physics3d.in);
+			physics3d.processRules();
+			referenceStep3D(physics3d, physics3d.in, next3d.data());
+
+			for (int i = 0; i < boids; ++i) {
+				const float r[6] = { next3d[i].x, next3d[i].y, next3d[i].z, next3d[i].vx, next3d[i].vy, next3d[i].vz };
+				const float k[6] = { physics3d.out[i].x, physics3d.out[i].y, physics3d.out[i].z, physics3d.out[i].vx, physics3d.out[i].vy, physics3d.out[i].vz };
+
+				for (int f = 0; f < 6; ++f) {
+					double abs_err = fabs(static_cast<double>(k[f]) - r[f]);
+					if (f < 3 && physics3d.wrap[f]) abs_err = std::min(abs_err, fP_MAX - abs_err);
+					int64_t ulps = ulpDistance(r[f], k[f]);
+					max_abs_seen = std::max(max_abs_seen, abs_err);
+					max_ulps_seen = std::max(max_ulps_seen, ulps);
+
+					if (ulps <= max_ulps || abs_err <= max_abs) continue;
+
+					++failures;
+					Mismatch m = { s, i, FIELD_NAMES_3D[f], r[f], k[f], abs_err, ulps };
+					worst_seen.push_back(m);
+				}
+			}
+
+			std::sort(worst_seen.begin(), worst_seen.end(), [](const Mismatch& a, const Mismatch& b) { return a.abs_err > b.abs_err; });
+			if (static_cast<int>(worst_seen.size()) > worst) worst_seen.resize(worst);
+
+			ref3d.swap(next3d);
+		}
+
+		printf("%-24s %s  max abs %.3g, max ulp %lld, %lld value(s) out of tolerance\n", "processRules (3D grid)", failures ? "FAIL" : "PASS", max_abs_seen, static_cast<long long>(max_ulps_seen), static_cast<long long>(failures));
+		for (const Mismatch& m : worst_seen)
+			printf("    step %3d  boid %5d  %-2s  ref % .9g  got % .9g  abs %.3g  ulp %lld\n", m.step, m.boid, m.field, m.ref, m.cand, m.abs_err, static_cast<long long>(m.ulps));
+
+		all_passed &= !failures;
+	}
+
+	return all_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}